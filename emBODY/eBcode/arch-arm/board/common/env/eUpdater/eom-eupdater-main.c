@@ -383,7 +383,8 @@ static void s_ethcommand_startup(EOMtask *p, uint32_t t)
     s_action_ethcmd = eo_action_New();  
 
     // initialise the socket 
-    s_skt_ethcmd = eo_socketdtg_New(  2, capacityofUDPpacket, eom_mutex_New(), // input queue
+    // the input queue holds the uprot_OPC_PROG_DATA packets that the host keeps in flight
+    s_skt_ethcmd = eo_socketdtg_New(  UPDATER_CORE_PROG_WINDOW, capacityofUDPpacket, eom_mutex_New(), // input queue
                                       2, capacityofUDPpacket, eom_mutex_New()  // output queue
                                    );   
 
@@ -66,7 +66,10 @@
 // --------------------------------------------------------------------------------------------------------------------
 // - #define with internal scope
 // --------------------------------------------------------------------------------------------------------------------
-// empty-section
+
+// the chunks already received which we remember to detect retransmissions. the host retransmits only chunks inside its window,
+// but the window may slide while the retransmission travels, hence we keep twice its size.
+#define PROG_CHUNKS_HISTORY     (2*UPDATER_CORE_PROG_WINDOW)
 
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -75,6 +78,12 @@
 
 typedef uint8_t (*uprot_fp_process_t) (eOuprot_opcodes_t, uint8_t *, uint16_t, eOipv4addr_t, uint8_t *, uint16_t, uint16_t *);
 
+typedef struct
+{
+    uint32_t    address;
+    uint16_t    size;
+} prog_chunk_t;
+
 
 // --------------------------------------------------------------------------------------------------------------------
 // - declaration of static functions
@@ -107,6 +116,10 @@ static eEresult_t s_sys_eeprom_erase(void);
 
 static uint8_t s_overlapping_with_code_space(uint32_t addr, uint32_t size);
 
+static void s_prog_chunks_reset(void);
+static uint8_t s_prog_chunks_isduplicate(uint32_t address, uint16_t size);
+static void s_prog_chunks_add(uint32_t address, uint16_t size);
+
 
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -116,6 +129,9 @@ static uint8_t s_overlapping_with_code_space(uint32_t addr, uint32_t size);
 
 static uint32_t s_process_capabilities  = uprot_canDO_nothing;
 
+static prog_chunk_t s_prog_chunks[PROG_CHUNKS_HISTORY] = {0};
+static uint8_t s_prog_chunks_next = 0;
+
 #if defined(_MAINTAINER_APPL_)
 static const eOuprot_process_t s_running_process = eApplPROGupdater;
 #else
@@ -403,6 +419,35 @@ static uint8_t s_overlapping_with_code_space(uint32_t addr, uint32_t size)
 }
 
 
+static void s_prog_chunks_reset(void)
+{
+    memset(s_prog_chunks, 0, sizeof(s_prog_chunks));
+    s_prog_chunks_next = 0;
+}
+
+
+static uint8_t s_prog_chunks_isduplicate(uint32_t address, uint16_t size)
+{
+    for(uint8_t i=0; i<PROG_CHUNKS_HISTORY; i++)
+    {
+        if((0 != s_prog_chunks[i].size) && (address == s_prog_chunks[i].address) && (size == s_prog_chunks[i].size))
+        {
+            return(1);
+        }
+    }
+    
+    return(0);
+}
+
+
+static void s_prog_chunks_add(uint32_t address, uint16_t size)
+{
+    s_prog_chunks[s_prog_chunks_next].address = address;
+    s_prog_chunks[s_prog_chunks_next].size = size;
+    s_prog_chunks_next = (s_prog_chunks_next + 1) % PROG_CHUNKS_HISTORY;
+}
+
+
 static void s_sys_reset(void)
 {
     hal_sys_irq_disable();
@@ -528,6 +573,7 @@ static uint8_t s_uprot_proc_PROGRAM(eOuprot_opcodes_t opc, uint8_t *pktin, uint1
         case uprot_OPC_PROG_START:
         {
             // we init everything for programming the FLASH ...       
+            s_prog_chunks_reset();
             s_proc_PROG_rxpackets = 1;
             s_proc_PROG_flash_erased = 0;    
             s_proc_PROG_downloading_partition = 0;   
@@ -640,6 +686,13 @@ static uint8_t s_uprot_proc_PROGRAM(eOuprot_opcodes_t opc, uint8_t *pktin, uint1
             uint16_t size = (cmd->size[0]) | (cmd->size[1] << 8);
             uint8_t *data = &cmd->data[0];
             
+            // every reply tells which chunk it refers to, so that the host can keep many of them in flight
+            uint8_t *extra = pktout + sizeof(eOuprot_cmdREPLY_t);
+            extra[0] = cmd->address[0]; extra[1] = cmd->address[1]; extra[2] = cmd->address[2]; extra[3] = cmd->address[3];
+            extra[4] = cmd->size[0]; extra[5] = cmd->size[1];
+            reply->sizeofextra = 6;
+            *sizeout = sizeof(eOuprot_cmdREPLY_t) + reply->sizeofextra;
+            
             // if i am not in programming mode, i quit
             if(0 == s_proc_PROG_downloading_partition)
             {
@@ -694,6 +747,11 @@ static uint8_t s_uprot_proc_PROGRAM(eOuprot_opcodes_t opc, uint8_t *pktin, uint1
 
             // ok, i can go on
             
+            // a retransmission of a chunk we already have (its reply was lost): we just acknowledge it again
+            if(1 == s_prog_chunks_isduplicate(address, size))
+            {
+                return ret;
+            }
 
             if(uprot_partitionLOADER == s_proc_PROG_downloading_partition)
             {   // if loader: i write into ram. no need to erase the flash at this stage
@@ -713,6 +771,7 @@ static uint8_t s_uprot_proc_PROGRAM(eOuprot_opcodes_t opc, uint8_t *pktin, uint1
                     return ret;
                 }
                 ++s_proc_PROG_rxpackets;            
+                s_prog_chunks_add(address, size);
                 
             }
             else // if updater or application
@@ -753,6 +812,8 @@ static uint8_t s_uprot_proc_PROGRAM(eOuprot_opcodes_t opc, uint8_t *pktin, uint1
                         reply->res = uprot_RES_ERR_PROT;
                         return ret;
                     }
+                    
+                    s_prog_chunks_add(address, size);
                 }
              
             }
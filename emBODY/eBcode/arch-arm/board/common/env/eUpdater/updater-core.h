@@ -25,6 +25,13 @@
 #include "EoCommon.h"
 
 
+// number of uprot_OPC_PROG_DATA packets that the host may keep in flight before it waits for their replies. the reply
+// of uprot_OPC_PROG_DATA carries in its extra bytes the address (4 bytes) and the size (2 bytes) of the chunk it refers
+// to, so that the host can retransmit only the lost chunks. a chunk received twice is acknowledged again but it is not
+// written nor counted twice. the socket of the eth commands must be able to queue this many packets.
+#define UPDATER_CORE_PROG_WINDOW    8
+
+
 extern void updater_core_init(void);
 
 extern void updater_core_trace(const char *caller, char *format, ...);
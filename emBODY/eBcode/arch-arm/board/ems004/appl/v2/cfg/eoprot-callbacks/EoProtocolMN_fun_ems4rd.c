@@ -882,6 +882,9 @@ static void s_eoprot_ep_mn_fun_apply_config(uint32_t period, uint16_t rxtime, ui
     
     eom_emsrunner_SetTiming(eom_emsrunner_GetHandle(), &timing); 
     
+    // the statistics collected with the old timing are not meaningful anymore
+    eom_emsrunner_ResetTimingStatistics(eom_emsrunner_GetHandle());
+    
     eom_emsrunner_Set_TXdecimationFactor(eom_emsrunner_GetHandle(), txratedivider);    
 }
 
@@ -657,7 +657,7 @@ const eOcanprot_functions_t s_eo_canprot_functions_periodicMotorControl[] =
         EO_INIT(.former) NULL,
         EO_INIT(.parser) NULL
     },
-    {   // 014
+    {   // 014      not assigned. the embot boards use it for their binary trace (embot::app::canprotocol::mcperCMD::TRACE)
         EO_INIT(.former) NULL,
         EO_INIT(.parser) NULL
     },
@@ -90,6 +90,7 @@ static void s_eo_canserv_ontx_can(void *arg);
 static void s_eo_canserv_onerror_can(void *arg);
 static eOresult_t s_eo_canserv_send_frame_simplemode(EOtheCANservice *p, eOcanport_t port, eOcanframe_t *frame);
 
+static eOresult_t s_eo_canserv_FormFrame(EOtheCANservice *p, eOcanprot_descriptor_t *descriptor, eOcanframe_t *frame);
 static eOresult_t s_eo_canserv_SendCommand(EOtheCANservice *p, eOcanprot_descriptor_t *command);
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -392,6 +393,34 @@ extern eOresult_t eo_canserv_SendCommandToLocation(EOtheCANservice *p, eOcanprot
     return(s_eo_canserv_SendCommand(p, &descriptor));
 }
 
+extern eOresult_t eo_canserv_FormFrame(EOtheCANservice *p, eOcanprot_command_t *command, eObrd_canlocation_t loc, eOcanframe_t *frame)
+{
+    if((NULL == p) || (NULL == command) || (NULL == frame))
+    {
+        return(eores_NOK_nullpointer);
+    }
+    
+    eOcanprot_descriptor_t descriptor = {0};
+    memcpy(&descriptor.cmd, command, sizeof(eOcanprot_command_t));
+    memcpy(&descriptor.loc, &loc, sizeof(eObrd_canlocation_t));
+    return(s_eo_canserv_FormFrame(p, &descriptor, frame));
+}
+
+extern eOresult_t eo_canserv_SendFrame(EOtheCANservice *p, eOcanport_t port, eOcanframe_t *frame)
+{
+    if((NULL == p) || (NULL == frame))
+    {
+        return(eores_NOK_nullpointer);
+    }
+    
+    if((port >= eOcanports_number) || (eobool_false == p->isactive[port]))
+    {
+        return(eores_NOK_generic);
+    }
+    
+    return(s_eo_canserv_send_frame_simplemode(p, port, frame));
+}
+
 //#warning ---> it is ok for all but for skin .......
 extern eOresult_t eo_canserv_SendCommandToEntity(EOtheCANservice *p, eOcanprot_command_t *command, eOprotID32_t id32)
 {
@@ -717,13 +746,11 @@ static eOresult_t s_eo_canserv_send_frame_simplemode(EOtheCANservice *p, eOcanpo
 }
 
 
-static eOresult_t s_eo_canserv_SendCommand(EOtheCANservice *p, eOcanprot_descriptor_t *descriptor)
+static eOresult_t s_eo_canserv_FormFrame(EOtheCANservice *p, eOcanprot_descriptor_t *descriptor, eOcanframe_t *frame)
 {   
     eOerrmanDescriptor_t errdes = {0};
-    // here is the frame
-    eOcanframe_t frame = {0};
     
-    if(eores_OK != eo_canprot_Form(eo_canprot_GetHandle(), descriptor, &frame))
+    if(eores_OK != eo_canprot_Form(eo_canprot_GetHandle(), descriptor, frame))
     {   // error ...
         errdes.code                 = eoerror_code_get(eoerror_category_System, eoerror_value_SYS_canservices_formingfailure);
         errdes.par16                = (descriptor->cmd.clas << 8) | (descriptor->cmd.type);
@@ -734,6 +761,20 @@ static eOresult_t s_eo_canserv_SendCommand(EOtheCANservice *p, eOcanprot_descrip
         return(eores_NOK_generic);
     }
     
+    return(eores_OK);
+}
+
+
+static eOresult_t s_eo_canserv_SendCommand(EOtheCANservice *p, eOcanprot_descriptor_t *descriptor)
+{   
+    // here is the frame
+    eOcanframe_t frame = {0};
+    
+    if(eores_OK != s_eo_canserv_FormFrame(p, descriptor, &frame))
+    {
+        return(eores_NOK_generic);
+    }
+    
     // ok now i can sent the frame over can. what i do depends on the mode.
     return(s_eo_canserv_send_frame_simplemode(p, (eOcanport_t)descriptor->loc.port, &frame));   
 }
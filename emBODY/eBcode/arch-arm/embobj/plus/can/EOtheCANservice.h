@@ -125,6 +125,28 @@ extern eOresult_t eo_canserv_Parse(EOtheCANservice *p, eOcanport_t canport, uint
 // must specify all the entries in eOcanprot_descriptor_t
 extern eOresult_t eo_canserv_SendCommandToLocation(EOtheCANservice *p, eOcanprot_command_t *command, eObrd_canlocation_t loc);
 
+/** @fn         extern eOresult_t eo_canserv_FormFrame(EOtheCANservice *p, eOcanprot_command_t *command, eObrd_canlocation_t loc, eOcanframe_t *frame)
+    @brief      It forms the can frame of a command without sending it. It is meant for the periodic commands: the frame
+                is formed only once and then, at every cycle, the caller patches its payload and sends it with eo_canserv_SendFrame(),
+                so that the lookup inside the can protocol is not repeated.
+    @param      p               The singleton
+    @param      command         The command, as in eo_canserv_SendCommandToLocation()
+    @param      loc             The destination.
+    @param      frame           The formed frame.
+    @return     eores_OK if the frame is formed, eores_NOK_nullpointer in case of NULL parameters, eores_NOK_generic if the command is not recognised.  
+ **/
+extern eOresult_t eo_canserv_FormFrame(EOtheCANservice *p, eOcanprot_command_t *command, eObrd_canlocation_t loc, eOcanframe_t *frame);
+
+/** @fn         extern eOresult_t eo_canserv_SendFrame(EOtheCANservice *p, eOcanport_t port, eOcanframe_t *frame)
+    @brief      It puts a frame already formed into the tx queue of a port, in the same way as the eo_canserv_SendCommand*() functions do.
+    @param      p               The singleton
+    @param      port            The can port
+    @param      frame           The frame.
+    @return     eores_OK if the frame is queued, eores_NOK_nullpointer in case of NULL parameters, eores_NOK_generic if the port is 
+                not active or its tx queue is full.  
+ **/
+extern eOresult_t eo_canserv_SendFrame(EOtheCANservice *p, eOcanport_t port, eOcanframe_t *frame);
+
 /** @fn         extern eOresult_t eo_canserv_Parse(EOtheCANservice *p, eOcanframe_t *frame, eOcanport_t port) 
     @brief      It parses a can frame and executes associated actions. 
     @param      p               The singleton
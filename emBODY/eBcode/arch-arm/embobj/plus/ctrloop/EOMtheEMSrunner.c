@@ -79,6 +79,13 @@
 
 //#define EOM_EMSRUNNER_EVIEW_MEASURES
 
+// the received packets are parsed in place inside the rx queue of the socket, without copying them out of it.
+// undefine it to go back to eom_emssocket_Receive()
+#define EOM_EMSRUNNER_RX_ZEROCOPY
+
+// every so many cycles the timing statistics are sent as debug diagnostics, one item per cycle. 0 disables it
+#define EOM_EMSRUNNER_STATS_REPORTEVERY     10000
+
 
 // --------------------------------------------------------------------------------------------------------------------
 // - definition (and initialisation) of extern variables, but better using _get(), _set() 
@@ -169,6 +176,14 @@ static void s_eom_emsrunner_tasktiming_on_exit(eOemsrunner_taskid_t taskid);
 static void s_eom_emsrunner_update_diagnosticsinfo_check_overflows2(eOemsrunner_taskid_t taskid);
 static void s_eom_emsrunner_tasktiming_eval(void);
 
+static void s_eom_emsrunner_histogram_add(eOemsrunner_histogram_t *h, eOabstime_t duration);
+static void s_eom_emsrunner_histogram_jitter(eOemsrunner_histogram_t *h, int32_t delay);
+static uint16_t s_eom_emsrunner_histogram_percentile(const eOemsrunner_histogram_t *h, uint8_t percent);
+static void s_eom_emsrunner_histogram_report(eOemsrunner_statsid_t id);
+
+
+static eOevent_t s_eom_emsrunner_adaptive_trigger_next(eOemsrunner_taskid_t taskid);
+static eObool_t s_eom_emsrunner_adaptive_trigger_deadline(eOemsrunner_taskid_t taskid);
 
 static void s_eom_runner_overflow_set(EOMtheEMSrunner *p, eOemsrunner_taskid_t taskid);
 static void s_eom_runner_overflow_clr(EOMtheEMSrunner *p, eOemsrunner_taskid_t taskid);
@@ -205,7 +220,7 @@ static EOMtheEMSrunner s_theemsrunner =
     EO_INIT(.txropsnumberincycle)   {0, 0, 0},
     EO_INIT(.txcan1frames)          0,
     EO_INIT(.txcan2frames)          0,
-    EO_INIT(.cycletiming)           { EO_INIT(.cycleisrunning) eobool_false, EO_INIT(.iterationnumber) 0, { {EO_INIT(.timestarted) 0, EO_INIT(.timestopped) 0, EO_INIT(.duration) {0, 0}, EO_INIT(.isexecuting) eobool_false, EO_INIT(.isabout2overflow) eobool_false, EO_INIT(.isoverflown) eobool_false} } },
+    EO_INIT(.cycletiming)           { EO_INIT(.cycleisrunning) eobool_false, EO_INIT(.iterationnumber) 0, { {EO_INIT(.timestarted) 0, EO_INIT(.timeentered) 0, EO_INIT(.timestopped) 0, EO_INIT(.duration) {0, 0}, EO_INIT(.isexecuting) eobool_false, EO_INIT(.isabout2overflow) eobool_false, EO_INIT(.isoverflown) eobool_false, EO_INIT(.trigger) EOM_EMSRUNNER_TRIGGER_NONE} } },
     EO_INIT(.isrunning)             eobool_false
 };
 
@@ -428,6 +443,45 @@ extern eOreltime_t eom_emsrunner_Get_Period(EOMtheEMSrunner *p)
 }
 
 
+extern eOresult_t eom_emsrunner_GetTimingStatistics(EOMtheEMSrunner *p, eOemsrunner_statsid_t id, eOemsrunner_timingstats_t *stats)
+{
+    if((NULL == p) || (NULL == stats))
+    {
+        return(eores_NOK_nullpointer);
+    }
+    
+    if(id >= eo_emsrunner_stats_numberof)
+    {
+        return(eores_NOK_generic);
+    }
+    
+    const eOemsrunner_histogram_t *h = &p->cycletiming.histogram[id];
+    
+    stats->count = h->count;
+    stats->overflows = h->overflows;
+    stats->p50 = s_eom_emsrunner_histogram_percentile(h, 50);
+    stats->p99 = s_eom_emsrunner_histogram_percentile(h, 99);
+    stats->max = (h->max > 0xffff) ? (0xffff) : (h->max);
+    stats->jittermin = (h->jittermin < -32768) ? (-32768) : (h->jittermin);
+    stats->jittermax = (h->jittermax > 32767) ? (32767) : (h->jittermax);
+    
+    return(eores_OK);
+}
+
+
+extern eOresult_t eom_emsrunner_ResetTimingStatistics(EOMtheEMSrunner *p)
+{
+    if(NULL == p)
+    {
+        return(eores_NOK_nullpointer);
+    }
+    
+    memset(p->cycletiming.histogram, 0, sizeof(p->cycletiming.histogram));
+    
+    return(eores_OK);
+}
+
+
 extern eOresult_t eom_emsrunner_Start(EOMtheEMSrunner *p)
 {    
     if(NULL == p)
@@ -543,6 +597,10 @@ extern eOresult_t eom_emsrunner_SetMode(EOMtheEMSrunner *p, eOemsrunner_mode_t m
 
     s_theemsrunner.mode = mode;
     
+    // a change of mode while running must not leave a pending trigger 
+    s_theemsrunner.cycletiming.tasktiming[eo_emsrunner_taskid_runDO].trigger = EOM_EMSRUNNER_TRIGGER_NONE;
+    s_theemsrunner.cycletiming.tasktiming[eo_emsrunner_taskid_runTX].trigger = EOM_EMSRUNNER_TRIGGER_NONE;
+    
     // note: "eo_emsrunner_mode_hardrealtime requires a change of policy in the parsing of a ropframe"
     eo_errman_Assert(eo_errman_GetHandle(), (eo_emsrunner_mode_hardrealtime != mode), "eom_emsrunner_SetMode(): eo_emsrunner_mode_hardrealtime ... see note", s_eobj_ownname, NULL);
      
@@ -756,8 +814,8 @@ static void s_eom_emsrunner_taskRX_run(EOMtask *p, uint32_t t)
    
     s_eom_emsrunner_tasktiming_on_exit(eo_emsrunner_taskid_runRX);
     
-    // Z. at the end enable next in the chain by sending to it a eo_emsrunner_evt_enable
-    eom_task_SetEvent(s_theemsrunner.task[eo_emsrunner_taskid_runDO], eo_emsrunner_evt_enable);
+    // Z. at the end enable next in the chain by sending to it a eo_emsrunner_evt_enable. in adaptive mode also execute it
+    eom_task_SetEvent(s_theemsrunner.task[eo_emsrunner_taskid_runDO], eo_emsrunner_evt_enable | s_eom_emsrunner_adaptive_trigger_next(eo_emsrunner_taskid_runDO));
 }
 
 
@@ -803,8 +861,17 @@ static void s_eom_emsrunner_userdef_taskRX_activity_datagramreception(EOMtheEMSr
         // 1. process one packet        
         processedpkts++;
 
+#if defined(EOM_EMSRUNNER_RX_ZEROCOPY)
+        // 1.1 get the packet in place. it is ours until we release it, and remainingrxpkts also counts it
+        resrx = eom_emssocket_ReceiveInPlace(eom_emssocket_GetHandle(), &rxpkt, &remainingrxpkts);
+        if((eores_OK == resrx) && (remainingrxpkts > 0))
+        {
+            remainingrxpkts--;
+        }
+#else
         // 1.1 get the packet. we need passing just a pointer because the storage is inside the EOMtheEMSsocket       
         resrx = eom_emssocket_Receive(eom_emssocket_GetHandle(), &rxpkt, &remainingrxpkts);
+#endif
         
         // 1.2 process the packet with the transceiver
         if(eores_OK == resrx)
@@ -817,6 +884,11 @@ static void s_eom_emsrunner_userdef_taskRX_activity_datagramreception(EOMtheEMSr
             }
             p->numofrxrops += tmp;
             p->numofrxpackets++;
+            
+#if defined(EOM_EMSRUNNER_RX_ZEROCOPY)
+            // 1.3 the ropframe is parsed: its slot can go back to the socket
+            eom_emssocket_ReleaseReceived(eom_emssocket_GetHandle());
+#endif
         }
         
         // 2. evaluate quit from the loop
@@ -875,8 +947,8 @@ static void s_eom_emsrunner_taskDO_run(EOMtask *p, uint32_t t)
     s_eom_emsrunner_tasktiming_on_exit(eo_emsrunner_taskid_runDO);
        
 		
-    // Z. at the end enable next in the chain by sending to it a eo_emsrunner_evt_enable
-    eom_task_SetEvent(s_theemsrunner.task[eo_emsrunner_taskid_runTX], eo_emsrunner_evt_enable);
+    // Z. at the end enable next in the chain by sending to it a eo_emsrunner_evt_enable. in adaptive mode also execute it
+    eom_task_SetEvent(s_theemsrunner.task[eo_emsrunner_taskid_runTX], eo_emsrunner_evt_enable | s_eom_emsrunner_adaptive_trigger_next(eo_emsrunner_taskid_runTX));
 }
 
 
@@ -1094,6 +1166,11 @@ static void s_eom_emsrunner_6HALTIMERS_execute_task(void *arg)
     eOemsrunner_taskid_t taskIDprevious = (eo_emsrunner_taskid_runRX == taskID2execute) ? (eo_emsrunner_taskid_runTX) : ((eOemsrunner_taskid_t)((uint8_t)taskID2execute-1));
 //    EOMtask* taskprevious = s_theemsrunner.task[taskIDprevious];
     
+    if(eobool_false == s_eom_emsrunner_adaptive_trigger_deadline(taskID2execute))
+    {   // in adaptive mode the task was already started by the completion of the previous one
+        return;
+    }
+    
     if(eobool_true == s_theemsrunner.cycletiming.tasktiming[taskIDprevious].isexecuting)
     {
         // damn ... the previous task has not finished yet .... i must mark an overflow for that task.
@@ -1109,6 +1186,56 @@ static void s_eom_emsrunner_6HALTIMERS_execute_task(void *arg)
 }
 
 
+static eOevent_t s_eom_emsrunner_adaptive_trigger_next(eOemsrunner_taskid_t taskid)
+{
+    // called by the previous task when it completes
+    if(eo_emsrunner_mode_adaptive != s_theemsrunner.mode)
+    {
+        return(0);
+    }
+    
+    eOemsrunner_tasktiming_t *tt = &s_theemsrunner.cycletiming.tasktiming[taskid];
+    eObool_t first = eobool_false;
+    
+    // the hal timer of the task may expire in the middle, so we decide with irqs disabled
+    hal_sys_irq_disable();
+    if(EOM_EMSRUNNER_TRIGGER_NONE == tt->trigger)
+    {
+        tt->trigger = EOM_EMSRUNNER_TRIGGER_PREVIOUS;
+        tt->timestarted = osal_system_abstime_get();
+        first = eobool_true;
+    }
+    else
+    {   // the deadline has already started the task in this cycle
+        tt->trigger = EOM_EMSRUNNER_TRIGGER_NONE;
+    }
+    hal_sys_irq_enable();
+    
+    return((eobool_true == first) ? ((eOevent_t)eo_emsrunner_evt_execute) : (0));
+}
+
+
+static eObool_t s_eom_emsrunner_adaptive_trigger_deadline(eOemsrunner_taskid_t taskid)
+{
+    // called by the hal timer of the task. it tells if the timer must start the task
+    if((eo_emsrunner_mode_adaptive != s_theemsrunner.mode) || (eo_emsrunner_taskid_runRX == taskid))
+    {
+        return(eobool_true);
+    }
+    
+    eOemsrunner_tasktiming_t *tt = &s_theemsrunner.cycletiming.tasktiming[taskid];
+    
+    if(EOM_EMSRUNNER_TRIGGER_PREVIOUS == tt->trigger)
+    {
+        tt->trigger = EOM_EMSRUNNER_TRIGGER_NONE;
+        return(eobool_false);
+    }
+    
+    tt->trigger = EOM_EMSRUNNER_TRIGGER_DEADLINE;
+    return(eobool_true);
+}
+
+
 static void s_eom_emsrunner_6HALTIMERS_safestop_check_task(void *arg)
 {
     eOemsrunner_taskid_t taskID2check = (eOemsrunner_taskid_t) (int32_t)arg;
@@ -1173,6 +1300,16 @@ static void s_eom_emsrunner_6HALTIMERS_start_periodic_timer_execute_task(void *a
 static void s_eom_emsrunner_tasktiming_on_entry(eOemsrunner_taskid_t taskid)
 {
     s_theemsrunner.cycletiming.tasktiming[taskid].isexecuting = eobool_true;   
+    s_theemsrunner.cycletiming.tasktiming[taskid].timeentered = osal_system_abstime_get();
+    
+    if(eo_emsrunner_taskid_runRX != taskid)
+    {   // the delay of the start of do and tx vs the nominal offset from rx. it includes the latency of the scheduler
+        // and the wait for the previous task to complete
+        const eOemsrunner_cfg_t *cfg = &s_theemsrunner.cfg;
+        eOreltime_t nominal = (eo_emsrunner_taskid_runDO == taskid) ? (cfg->execDOafter) : (cfg->execTXafter);
+        int32_t offset = (int32_t)(s_theemsrunner.cycletiming.tasktiming[taskid].timeentered - s_theemsrunner.cycletiming.tasktiming[eo_emsrunner_taskid_runRX].timestarted);
+        s_eom_emsrunner_histogram_jitter(&s_theemsrunner.cycletiming.histogram[taskid], offset - (int32_t)(nominal - cfg->execRXafter));
+    }
 }
 
 
@@ -1187,6 +1324,98 @@ static void s_eom_emsrunner_tasktiming_on_exit(eOemsrunner_taskid_t taskid)
     s_theemsrunner.cycletiming.tasktiming[taskid].duration[1] = s_theemsrunner.cycletiming.tasktiming[taskid].duration[0]; 
     s_theemsrunner.cycletiming.tasktiming[taskid].duration[0] = s_theemsrunner.cycletiming.tasktiming[taskid].timestopped - s_theemsrunner.cycletiming.tasktiming[taskid].timestarted;
     s_theemsrunner.cycletiming.tasktiming[taskid].isexecuting = eobool_false;      
+    
+    s_eom_emsrunner_histogram_add(&s_theemsrunner.cycletiming.histogram[taskid], s_theemsrunner.cycletiming.tasktiming[taskid].duration[0]);
+    
+    if(eo_emsrunner_taskid_runTX == taskid)
+    {
+        s_eom_emsrunner_histogram_add(&s_theemsrunner.cycletiming.histogram[eo_emsrunner_statsid_cycle], s_theemsrunner.cycletiming.tasktiming[taskid].timestopped - s_theemsrunner.cycletiming.tasktiming[eo_emsrunner_taskid_runRX].timestarted);
+    }
+}
+
+
+static void s_eom_emsrunner_histogram_add(eOemsrunner_histogram_t *h, eOabstime_t duration)
+{
+    uint32_t d = (duration > 0xffffffff) ? (0xffffffff) : ((uint32_t)duration);
+    uint32_t bin = d / EOM_EMSRUNNER_HISTO_BINWIDTH;
+    
+    if(bin >= EOM_EMSRUNNER_HISTO_BINS)
+    {
+        bin = EOM_EMSRUNNER_HISTO_BINS - 1;
+    }
+    
+    h->bins[bin]++;
+    h->count++;
+    
+    if(d > h->max)
+    {
+        h->max = d;
+    }
+}
+
+
+static void s_eom_emsrunner_histogram_jitter(eOemsrunner_histogram_t *h, int32_t delay)
+{
+    // the jitter is sampled at the start, before the first duration is added
+    if(0 == h->count)
+    {
+        h->jittermin = h->jittermax = delay;
+        return;
+    }
+    
+    if(delay < h->jittermin)
+    {
+        h->jittermin = delay;
+    }
+    
+    if(delay > h->jittermax)
+    {
+        h->jittermax = delay;
+    }
+}
+
+
+static uint16_t s_eom_emsrunner_histogram_percentile(const eOemsrunner_histogram_t *h, uint8_t percent)
+{
+    if(0 == h->count)
+    {
+        return(0);
+    }
+    
+    // the smallest upper edge of a bin below which there is at least percent % of the samples
+    uint64_t target = ((uint64_t)h->count * percent + 99) / 100;
+    uint64_t cumulative = 0;
+    uint32_t value = h->max;
+    
+    for(uint8_t i=0; i<EOM_EMSRUNNER_HISTO_BINS; i++)
+    {
+        cumulative += h->bins[i];
+        if(cumulative >= target)
+        {
+            uint32_t edge = (i+1) * EOM_EMSRUNNER_HISTO_BINWIDTH;
+            value = (edge < h->max) ? (edge) : (h->max);
+            break;
+        }
+    }
+    
+    return((value > 0xffff) ? (0xffff) : (value));
+}
+
+
+static void s_eom_emsrunner_histogram_report(eOemsrunner_statsid_t id)
+{
+    eOemsrunner_timingstats_t stats = {0};
+    eom_emsrunner_GetTimingStatistics(&s_theemsrunner, id, &stats);
+    
+    // par16 keeps the id and the number of overflows, par64 the p50, p99, max durations and the max jitter
+    eOerrmanDescriptor_t errdes = {0};
+    errdes.code             = eoerror_code_get(eoerror_category_Debug, eoerror_value_DEB_tag05);
+    errdes.sourcedevice     = eo_errman_sourcedevice_localboard;
+    errdes.sourceaddress    = id;
+    errdes.par16            = (stats.overflows > 0x0fff) ? (0x0fff) : (stats.overflows & 0x0fff);
+    errdes.par16           |= ((uint16_t)id << 12);
+    errdes.par64            = (uint64_t)stats.p50 | ((uint64_t)stats.p99 << 16) | ((uint64_t)stats.max << 32) | ((uint64_t)(uint16_t)stats.jittermax << 48);
+    eo_errman_Error(eo_errman_GetHandle(), eo_errortype_debug, "runner timing stats", s_eobj_ownname, &errdes);
 }
 
 
@@ -1196,6 +1425,15 @@ static void s_eom_emsrunner_tasktiming_eval(void)
     s_eom_emsrunner_update_diagnosticsinfo_check_overflows2(eo_emsrunner_taskid_runRX);
     s_eom_emsrunner_update_diagnosticsinfo_check_overflows2(eo_emsrunner_taskid_runDO);
     s_eom_emsrunner_update_diagnosticsinfo_check_overflows2(eo_emsrunner_taskid_runTX);    
+    
+#if (EOM_EMSRUNNER_STATS_REPORTEVERY > 0)
+    // one item per cycle so that we dont burst the diagnostics
+    uint32_t phase = s_theemsrunner.cycletiming.iterationnumber % EOM_EMSRUNNER_STATS_REPORTEVERY;
+    if(phase < eo_emsrunner_stats_numberof)
+    {
+        s_eom_emsrunner_histogram_report((eOemsrunner_statsid_t)phase);
+    }
+#endif
 }
 
 
@@ -1273,6 +1511,11 @@ static void s_eom_emsrunner_update_diagnosticsinfo_check_overflows2(eOemsrunner_
         } break;
 	}
     
+    if(eobool_true == s_theemsrunner.cycletiming.tasktiming[taskid].isoverflown)
+    {
+        s_theemsrunner.cycletiming.histogram[taskid].overflows++;
+    }
+    
     // must clear
     s_eom_runner_overflow_clr(&s_theemsrunner, taskid);
     
@@ -1372,6 +1615,7 @@ static void s_eom_emsrunner_6HALTIMERS_start(EOMtheEMSrunner *p)
     p->cycletiming.iterationnumber = 0;
     
     memset(&s_theemsrunner.cycletiming.tasktiming, 0, sizeof(s_theemsrunner.cycletiming.tasktiming));
+    memset(&s_theemsrunner.cycletiming.histogram, 0, sizeof(s_theemsrunner.cycletiming.histogram));
 
     // finally: we activate the hal timers. it is best to avoid any interruption in here, thus we disable scheduling
     //osal_system_scheduling_suspend();
@@ -1419,6 +1663,11 @@ extern eObool_t eom_runner_cansafelyexecute(EOMtheEMSrunner *p, eOemsrunner_task
         {
             ret = (eobool_false == p->cycletiming.tasktiming[taskid].isabout2overflow) ? (eobool_true) : (eobool_false);
         } break;  
+        
+        case eo_emsrunner_mode_adaptive:
+        {   // the start moves earlier but the safe stop of each task stays where it is
+            ret = (eobool_false == p->cycletiming.tasktiming[taskid].isabout2overflow) ? (eobool_true) : (eobool_false);
+        } break;
 
         default:
         {
@@ -72,6 +72,21 @@ typedef enum
 enum { eo_emsrunner_task_numberof   = 3 };
 
 
+/** @typedef    typedef enum eOemsrunner_statsid_t 
+    @brief      The timing statistics kept by the runner: one for each task (same value of eOemsrunner_taskid_t)
+                and one for the whole cycle, from the start of RX to the end of TX.
+ **/
+typedef enum
+{
+    eo_emsrunner_statsid_runRX      = eo_emsrunner_taskid_runRX,
+    eo_emsrunner_statsid_runDO      = eo_emsrunner_taskid_runDO,
+    eo_emsrunner_statsid_runTX      = eo_emsrunner_taskid_runTX,
+    eo_emsrunner_statsid_cycle      = 3
+} eOemsrunner_statsid_t;
+
+enum { eo_emsrunner_stats_numberof  = 4 };
+
+
 typedef enum
 {
     eo_emsrunner_evt_enable         = 0x00000001,
@@ -84,7 +99,8 @@ typedef enum
 {
     eo_emsrunner_mode_besteffort        = 0,
     eo_emsrunner_mode_softrealtime      = 1,
-    eo_emsrunner_mode_hardrealtime      = 2
+    eo_emsrunner_mode_hardrealtime      = 2,
+    eo_emsrunner_mode_adaptive          = 3     /**< as softrealtime, but DO and TX start as soon as the previous task completes. execDOafter and execTXafter become their deadlines */
 } eOemsrunner_mode_t;
 
 
@@ -124,6 +140,22 @@ typedef struct
 
 
 
+/**	@typedef    typedef struct eOemsrunner_timingstats_t 
+ 	@brief      The timing statistics of a task or of the whole cycle since their last reset. All times are in usec.
+                The percentiles have the resolution of the bins of the histogram.
+ **/
+typedef struct
+{
+    uint32_t            count;                  /**< number of executions */
+    uint32_t            overflows;              /**< number of executions which overflowed into the next task */
+    uint16_t            p50;                    /**< median duration */
+    uint16_t            p99;                    /**< 99-th percentile of the duration */
+    uint16_t            max;                    /**< max duration */
+    int16_t             jittermin;              /**< min delay of the start vs its nominal time (execDOafter, execTXafter). not used for RX and cycle */
+    int16_t             jittermax;              /**< max delay of the start vs its nominal time */
+} eOemsrunner_timingstats_t;
+
+
 // - declaration of extern public variables, ... but better using use _get/_set instead -------------------------------
 
 extern const eOemsrunner_cfg_t eom_emsrunner_DefaultCfg; // = {.taskpriority = {250, 251, 252}, .taskstacksize = {1024, 1024, 1024}, 
@@ -163,6 +195,23 @@ extern uint64_t eom_emsrunner_Get_IterationNumber(EOMtheEMSrunner *p);
 
 extern eOreltime_t eom_emsrunner_Get_Period(EOMtheEMSrunner *p);
 
+/** @fn         extern eOresult_t eom_emsrunner_GetTimingStatistics(EOMtheEMSrunner *p, eOemsrunner_statsid_t id, eOemsrunner_timingstats_t *stats)
+    @brief      Gives the timing statistics of a task or of the whole cycle, computed from a fixed-bin histogram of
+                the durations. The runner also sends them as debug diagnostics every EOM_EMSRUNNER_STATS_REPORTEVERY cycles.
+    @arg        p           The handle
+    @arg        id          The task or eo_emsrunner_statsid_cycle
+    @arg        stats       The statistics
+    @return     eores_OK or eores_NOK_nullpointer / eores_NOK_generic on wrong params.
+ **/
+extern eOresult_t eom_emsrunner_GetTimingStatistics(EOMtheEMSrunner *p, eOemsrunner_statsid_t id, eOemsrunner_timingstats_t *stats);
+
+/** @fn         extern eOresult_t eom_emsrunner_ResetTimingStatistics(EOMtheEMSrunner *p)
+    @brief      Clears the histograms of all the tasks and of the cycle. It is also done at every eom_emsrunner_Start().
+    @arg        p           The handle
+    @return     eores_OK or eores_NOK_nullpointer.
+ **/
+extern eOresult_t eom_emsrunner_ResetTimingStatistics(EOMtheEMSrunner *p);
+
 // start 
 extern eOresult_t eom_emsrunner_Start(EOMtheEMSrunner *p);
 
@@ -50,6 +50,16 @@ extern "C" {
 
 // - #define used with hidden struct ----------------------------------------------------------------------------------
 
+// the values of eOemsrunner_tasktiming_t::trigger. in adaptive mode DO and TX are started by the first of two events:
+// the completion of the previous task or their hal timer, which is the deadline. the second one resets the trigger.
+#define EOM_EMSRUNNER_TRIGGER_NONE          0
+#define EOM_EMSRUNNER_TRIGGER_PREVIOUS      1
+#define EOM_EMSRUNNER_TRIGGER_DEADLINE      2
+
+// the histograms of the durations have bins of 16 usec and cover up to 1024 usec. longer durations go in the last bin
+#define EOM_EMSRUNNER_HISTO_BINS            64
+#define EOM_EMSRUNNER_HISTO_BINWIDTH        16
+
 
 // - definition of the hidden struct implementing the object ----------------------------------------------------------
 
@@ -58,19 +68,33 @@ extern "C" {
 typedef struct
 {
     eOabstime_t         timestarted;
+    eOabstime_t         timeentered;
     eOabstime_t         timestopped;
     eOabstime_t         duration[2];    // 0 is current iteration, 1 is previous iteration
     volatile eObool_t   isexecuting;
     volatile eObool_t   isabout2overflow;
     volatile eObool_t   isoverflown;
+    volatile uint8_t    trigger;        // only in adaptive mode: what has started the task in the current cycle
 } eOemsrunner_tasktiming_t;
 
 
+typedef struct
+{
+    uint32_t            bins[EOM_EMSRUNNER_HISTO_BINS];
+    uint32_t            count;
+    uint32_t            overflows;
+    uint32_t            max;
+    int32_t             jittermin;
+    int32_t             jittermax;
+} eOemsrunner_histogram_t;
+
+
 typedef struct
 {
     eObool_t                    cycleisrunning;
     uint64_t                    iterationnumber;
     eOemsrunner_tasktiming_t    tasktiming[eo_emsrunner_task_numberof];    
+    eOemsrunner_histogram_t     histogram[eo_emsrunner_stats_numberof];
 } eOemsrunner_cycletiming_t;
 
 
@@ -258,6 +258,11 @@ extern eOresult_t eom_emssocket_Receive(EOMtheEMSsocket *p, EOpacket** rxpkt, eO
     else
     {
         eo_socketdtg_Received_NumberOf(p->socket, remaining);
+        
+        uint8_t *data = NULL;
+        uint16_t size = 0;
+        eo_packet_Payload_Get(p->rxpkt, &data, &size);
+        eom_ipnet_Account_RXbytesCopied(eom_ipnet_GetHandle(), size);
     }
     
     *rxpkt = p->rxpkt;
@@ -266,6 +271,47 @@ extern eOresult_t eom_emssocket_Receive(EOMtheEMSsocket *p, EOpacket** rxpkt, eO
 }
 
 
+extern eOresult_t eom_emssocket_ReceiveInPlace(EOMtheEMSsocket *p, EOpacket** rxpkt, eOsizecntnr_t* remaining)
+{
+    eOresult_t res;
+    
+    if(NULL != remaining)
+    {
+        *remaining = 0;
+    }       
+    
+    if((NULL == p) || (NULL == rxpkt))
+    {
+        return(eores_NOK_nullpointer);
+    }
+    
+    *rxpkt = NULL;
+    
+    if(eobool_false == p->active)
+    { 
+        return(eores_NOK_generic);
+    }  
+
+    // the count includes the packet we are about to take because it is removed only by the release
+    eo_socketdtg_Received_NumberOf(p->socket, remaining);
+    
+    res = eo_socketdtg_Peek(p->socket, rxpkt, eok_reltimeZERO);
+    
+    return(res);  
+}
+
+
+extern eOresult_t eom_emssocket_ReleaseReceived(EOMtheEMSsocket *p)
+{
+    if(NULL == p)
+    {
+        return(eores_NOK_nullpointer);
+    }
+    
+    return(eo_socketdtg_Release(p->socket));
+}
+
+
 extern eOresult_t eom_emssocket_Connect(EOMtheEMSsocket *p, eOipv4addr_t remaddr, eOreltime_t timeout)
 {
     eOresult_t res = eores_OK;
@@ -126,6 +126,19 @@ extern eOsizecntnr_t eom_emssocket_NumberOfReceivedPackets(EOMtheEMSsocket *p);
 
 extern eOresult_t eom_emssocket_Receive(EOMtheEMSsocket *p, EOpacket** rxpkt, eOsizecntnr_t* remaining);  
 
+/** @fn         extern eOresult_t eom_emssocket_ReceiveInPlace(EOMtheEMSsocket *p, EOpacket** rxpkt, eOsizecntnr_t* remaining)
+    @brief      As eom_emssocket_Receive() but the packet is not copied: it stays inside the rx queue of the socket
+                and it is owned by the caller until eom_emssocket_ReleaseReceived(), which must be called after
+                its parsing and before the next reception.
+    @arg        p               The handle to the object
+    @arg        rxpkt           It receives the pointer to the packet, or NULL if there is none.
+    @arg        remaining       It receives the number of packets still in the queue, this one included.
+    @return     As eom_emssocket_Receive().
+ **/
+extern eOresult_t eom_emssocket_ReceiveInPlace(EOMtheEMSsocket *p, EOpacket** rxpkt, eOsizecntnr_t* remaining);
+
+extern eOresult_t eom_emssocket_ReleaseReceived(EOMtheEMSsocket *p);
+
 extern eOresult_t eom_emssocket_Connect(EOMtheEMSsocket *p, eOipv4addr_t remaddr, eOreltime_t timeout); 
 
 extern eOresult_t eom_emssocket_Transmit(EOMtheEMSsocket *p, EOpacket* txpkt, eOreltime_t timeout);   
@@ -102,7 +102,9 @@ eOmipnet_diagnosticsinfo_t eom_ipnet_diagnosticsInfo  =
     EO_INIT(.datagrams_failed_to_go_in_rxfifo)              0,
     EO_INIT(.datagrams_failed_to_go_in_txosalqueue)         0,
     EO_INIT(.datagrams_failed_to_be_retrieved_from_txfifo)  0,
-    EO_INIT(.datagrams_failed_to_be_sent_by_ipal)           0    
+    EO_INIT(.datagrams_failed_to_be_sent_by_ipal)           0,
+    EO_INIT(.rxbytes_copied)                                0,
+    EO_INIT(.rxbytes_copied_lastsecond)                     0
 };
 
 
@@ -689,6 +691,30 @@ extern  eOmipnet_diagnosticsinfo_t * eom_ipnet_GetDiagnosticsInfoHandle(EOMtheIP
 
 }
 
+
+extern void eom_ipnet_Account_RXbytesCopied(EOMtheIPnet *ip, uint32_t bytes)
+{
+    static eOabstime_t windowstart = 0;
+    static uint32_t windowbytes = 0;
+    
+    if(NULL == ip)
+    {
+        return;
+    }
+    
+    eOabstime_t now = osal_system_abstime_get();
+    
+    if((now - windowstart) >= eok_reltime1sec)
+    {
+        eom_ipnet_diagnosticsInfo.rxbytes_copied_lastsecond = windowbytes;
+        windowbytes = 0;
+        windowstart = now;
+    }
+    
+    windowbytes += bytes;
+    eom_ipnet_diagnosticsInfo.rxbytes_copied += bytes;
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // - definition of extern hidden functions 
 // --------------------------------------------------------------------------------------------------------------------
@@ -1323,6 +1349,9 @@ static void s_eom_ipnet_OnReceptionDatagram(void *arg, ipal_udpsocket_t *skt, ip
         // return because ... we did not put the message in the queue and thus ... we dont want do any action on reception
         return;
     }
+    
+    // ipal frees pkt after this callback, so this copy cannot be avoided. the others can
+    eom_ipnet_Account_RXbytesCopied(&s_eom_theipnet, pkt->size);
 
 
     // do registered action on reception
@@ -122,6 +122,8 @@ typedef struct
     uint32_t    datagrams_failed_to_go_in_txosalqueue;
     uint32_t    datagrams_failed_to_be_retrieved_from_txfifo;
     uint32_t    datagrams_failed_to_be_sent_by_ipal;    
+    uint32_t    rxbytes_copied;                 // bytes of received datagrams copied since bootstrap
+    uint32_t    rxbytes_copied_lastsecond;      // the same, but only during the last completed second
 } eOmipnet_diagnosticsinfo_t;
    
 // - declaration of extern public variables, ... but better using use _get/_set instead -------------------------------
@@ -238,6 +240,10 @@ extern eOresult_t eom_ipnet_GetDiagnosticsInfo(EOMtheIPnet *ip, eOmipnet_diagnos
 //return pointer to diagnostics internal data
 extern  eOmipnet_diagnosticsinfo_t * eom_ipnet_GetDiagnosticsInfoHandle(EOMtheIPnet *ip);
 
+// every layer which copies a received datagram accounts for it in here, so that rxbytes_copied and 
+// rxbytes_copied_lastsecond tell how many memcpy passes the reception costs
+extern void eom_ipnet_Account_RXbytesCopied(EOMtheIPnet *ip, uint32_t bytes);
+
 /** @}            
     end of group eom_theipnet  
  **/
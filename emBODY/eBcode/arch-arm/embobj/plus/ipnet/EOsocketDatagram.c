@@ -129,6 +129,8 @@ extern EOsocketDatagram* eo_socketdtg_New(uint8_t dtg_in_num, uint16_t dtg_in_si
 
     retptr->toutfifos           = eok_reltimeINFINITE;
     
+    retptr->peeked              = NULL;
+    
     retptr->txtimer             = eo_timer_New();
 
     memcpy(&retptr->txmode, &eo_sktdtg_TXnow, sizeof(eOsktdtgTXmode_t));
@@ -395,6 +397,12 @@ extern eOresult_t eo_socketdtg_Get(EOsocketDatagram *p, EOpacket *pkt, eOreltime
         return(eores_NOK_generic);
     }
     
+    // a datagram given by eo_socketdtg_Peek() must be released first
+    if(NULL != p->peeked)
+    {
+        return(eores_NOK_generic);
+    }
+    
     // get pkt from input queue.
 
     if(eobool_true == p->socket->block2wait4packet)
@@ -420,6 +428,72 @@ extern eOresult_t eo_socketdtg_Get(EOsocketDatagram *p, EOpacket *pkt, eOreltime
 
 
 
+extern eOresult_t eo_socketdtg_Peek(EOsocketDatagram *p, EOpacket **pkt, eOreltime_t blockingtimeout)
+{
+    const void *titem = NULL;
+    eOresult_t res = eores_NOK_generic;
+
+
+    if((NULL == p) || (NULL == pkt)) 
+    {
+        return(eores_NOK_nullpointer);
+    }
+    
+    *pkt = NULL;
+    
+    // if tx-only ... i cannot receive
+    if(eo_sktdir_TXonly == p->socket->dir)
+    {
+        return(eores_NOK_generic);
+    }
+    
+    // the previous one must be released first: it is still the head of the fifo
+    if(NULL != p->peeked)
+    {
+        return(eores_NOK_generic);
+    }
+    
+    if(eobool_true == p->socket->block2wait4packet)
+    {
+        res = eov_ipnet_WaitPacket(eov_ipnet_GetHandle(), p, blockingtimeout);
+
+        if(eores_OK != res)
+        {
+            return(eores_NOK_timeout);
+        }
+    }
+ 
+    // we keep the item inside the fifo: the ipnet task puts new datagrams only in the free slots
+    res = eo_fifo_Get(p->dgramfifoinput, &titem, p->toutfifos);
+
+    if(eores_OK == res) 
+    {
+        p->peeked = (const EOpacket*)titem;
+        *pkt = (EOpacket*)titem;
+    }
+    
+    return(res);        
+}
+
+
+extern eOresult_t eo_socketdtg_Release(EOsocketDatagram *p)
+{
+    if(NULL == p) 
+    {
+        return(eores_NOK_nullpointer);
+    }
+    
+    if(NULL == p->peeked)
+    {
+        return(eores_NOK_generic);
+    }
+    
+    p->peeked = NULL;
+    
+    return(eo_fifo_Rem(p->dgramfifoinput, eok_reltimeINFINITE));
+}
+
+
 extern eOresult_t eo_socketdtg_Received_NumberOf(EOsocketDatagram *p, eOsizecntnr_t *numberof)
 {
     eOresult_t res = eores_NOK_generic;
@@ -219,6 +219,27 @@ extern eOresult_t eo_socketdtg_Put(EOsocketDatagram *p, EOpacket *pkt);
 extern eOresult_t eo_socketdtg_Get(EOsocketDatagram *p, EOpacket *pkt, eOreltime_t blockingtimeout);
 
 
+/** @fn         extern eOresult_t eo_socketdtg_Peek(EOsocketDatagram *p, EOpacket **pkt, eOreltime_t blockingtimeout)
+    @brief      As eo_socketdtg_Get() but without any copy: it gives the oldest received datagram in place inside the
+                FIFO queue. The caller owns it until eo_socketdtg_Release() and must call it before the next 
+                eo_socketdtg_Peek() or eo_socketdtg_Get(). Meanwhile the socket keeps on receiving into the other
+                slots of the queue.
+    @param      p               The object pointer. 
+    @param      pkt             It receives the pointer to the datagram, or NULL.
+    @param      blockingtimeout As for eo_socketdtg_Get().
+    @return     As for eo_socketdtg_Get().
+ **/
+extern eOresult_t eo_socketdtg_Peek(EOsocketDatagram *p, EOpacket **pkt, eOreltime_t blockingtimeout);
+
+
+/** @fn         extern eOresult_t eo_socketdtg_Release(EOsocketDatagram *p)
+    @brief      Removes from the FIFO queue the datagram given by eo_socketdtg_Peek().
+    @param      p               The object pointer. 
+    @return     eores_OK upon success, eores_NOK_nullpointer if p is NULL, eores_NOK_generic if there is nothing to release.
+ **/
+extern eOresult_t eo_socketdtg_Release(EOsocketDatagram *p);
+
+
 extern eOresult_t eo_socketdtg_Received_NumberOf(EOsocketDatagram *p, eOsizecntnr_t *numberof);
 
 
@@ -64,6 +64,7 @@ struct EOsocketDatagram_hid
     EOtimer                 *txtimer;
     eOsktdtgTXmode_t        txmode;  
     EOaction                *actiontx;
+    const EOpacket          *peeked;            /**< the datagram given by eo_socketdtg_Peek() and not released yet */
 }; 
 
 
@@ -18,11 +18,11 @@
 
 #include "EoCommon.h"
 
+#include "math.h"
+
 #include "EoError.h"
 #include "EOtheErrorManager.h"
 
-#include "EOMtheEMSrunner.h"
-
 #include "EOemsControllerCfg.h"
 
 #include "AbsEncoder.h"
@@ -34,6 +34,14 @@
 
 
 #define AEA_MIN_SPIKE 16 //4 bitsof zero padding(aea use 12 bits)
+
+#define MIN(a,b) ((a)<(b)?(a):(b))
+#define MAX(a,b) ((a)>(b)?(a):(b))
+
+static void AbsEncoder_filter_reset(AbsEncoder* o, uint16_t position);
+static int16_t AbsEncoder_median(AbsEncoder* o, uint16_t position);
+static void AbsEncoder_velocity_step(AbsEncoder* o, int16_t delta);
+static void AbsEncoder_spike_report(AbsEncoder* o);
           
 
 AbsEncoder* AbsEncoder_new(uint8_t n)
@@ -86,6 +94,13 @@ void AbsEncoder_init(AbsEncoder* o)
     o->fault_state_prec.bitmask = 0;
     o->fault_state.bitmask = 0;
     o->diagnostics_refresh = 0;
+    o->spike_report_timer = 0;
+    
+    o->filter = ABS_ENCODER_FILTER_IIR;
+    o->median = 0;
+    o->ab_alpha = 0.0f;
+    o->ab_beta = 0.0f;
+    AbsEncoder_filter_reset(o, 0);
     
     o->valid_first_data_cnt = 0;
     
@@ -174,6 +189,74 @@ extern void AbsEncoder_config_divisor(AbsEncoder* o, int32_t divisor)
         s_AbsEncoder_set_spikes_limis(o);
 }
 
+void AbsEncoder_config_filter(AbsEncoder* o, uint8_t filter, uint8_t median, float bandwidth)
+{
+    o->filter = filter;
+    
+    o->median = (median >= 5) ? 5 : ((median >= 3) ? 3 : 0);
+    
+    // critically damped alpha-beta: theta = exp(-2*pi*bandwidth*T), alpha = 1-theta^2, beta = (1-theta)^2
+    float theta = expf(-6.2831853f*bandwidth*CTRL_LOOP_PERIOD);
+    
+    o->ab_alpha = 1.0f - theta*theta;
+    o->ab_beta  = (1.0f - theta)*(1.0f - theta);
+    
+    AbsEncoder_filter_reset(o, o->position_sure);
+}
+
+static void AbsEncoder_filter_reset(AbsEncoder* o, uint16_t position)
+{
+    for (int k=0; k<ABS_ENCODER_MEDIAN_MAX; ++k) o->window[k] = position;
+    
+    o->ab_error = 0.0f;
+    o->ab_velocity = 0.0f;
+}
+
+// the median of the last 3 or 5 raw positions, as a displacement from position_sure. the sorting networks have
+// only min and max, which the compiler turns into conditional moves
+static int16_t AbsEncoder_median(AbsEncoder* o, uint16_t position)
+{
+    for (int k=ABS_ENCODER_MEDIAN_MAX-1; k>0; --k) o->window[k] = o->window[k-1];
+    
+    o->window[0] = position;
+    
+    int32_t a = (int16_t)(o->window[0] - o->position_sure);
+    int32_t b = (int16_t)(o->window[1] - o->position_sure);
+    int32_t c = (int16_t)(o->window[2] - o->position_sure);
+    
+    if (o->median == 3)
+    {
+        return (int16_t)MAX(MIN(a,b), MIN(MAX(a,b),c));
+    }
+    
+    int32_t d = (int16_t)(o->window[3] - o->position_sure);
+    int32_t e = (int16_t)(o->window[4] - o->position_sure);
+    
+    // median of 5 with 7 comparisons
+    int32_t f = MAX(MIN(a,b), MIN(c,d));
+    int32_t g = MIN(MAX(a,b), MAX(c,d));
+    
+    return (int16_t)MAX(MIN(f,g), MIN(MAX(f,g),e));
+}
+
+static void AbsEncoder_velocity_step(AbsEncoder* o, int16_t delta)
+{
+    if (o->filter == ABS_ENCODER_FILTER_ALPHA_BETA)
+    {
+        // the measure has just moved by delta: the residual is what the prediction has missed
+        float r = (float)delta - (o->ab_error + o->ab_velocity*CTRL_LOOP_PERIOD);
+        
+        o->ab_error = (1.0f - o->ab_alpha)*(-r);
+        o->ab_velocity += o->ab_beta*CTRL_LOOP_FREQUENCY*r;
+        
+        o->velocity = (int32_t)o->ab_velocity;
+    }
+    else
+    {
+        o->velocity = (7*o->velocity + ((int32_t)CTRL_LOOP_FREQUENCY)*delta) >> 3;
+    }
+}
+
 void AbsEncoder_start_hard_stop_calibrate(AbsEncoder* o, int32_t hard_stop_zero)
 {
     o->offset = 0;
@@ -267,6 +350,8 @@ static void AbsEncoder_position_init_aea(AbsEncoder* o, uint16_t position)
 
         o->valid_first_data_cnt = 0;
         
+        AbsEncoder_filter_reset(o, o->position_sure);
+        
         o->state.bits.not_initialized = FALSE;
     }
 }
@@ -288,6 +373,8 @@ static void AbsEncoder_position_init_others(AbsEncoder* o, uint16_t position)
 
     o->valid_first_data_cnt = 0;
     
+    AbsEncoder_filter_reset(o, o->position_sure);
+    
     o->state.bits.not_initialized = FALSE;
 
 }
@@ -432,8 +519,25 @@ void AbsEncoder_update(AbsEncoder* o, uint16_t position)
     int16_t check = position - o->position_last;
     
     o->position_last = position;
-
-    if( (o->spike_mag_limit == 0) || (-o->spike_mag_limit <= check && check <= o->spike_mag_limit))
+    
+    if (o->median)
+    {
+        // the median replaces the sample, and a sample far from it is a spike
+        int16_t delta = AbsEncoder_median(o, position);
+        
+        int16_t spike = (int16_t)(position - o->position_sure) - delta;
+        
+        if (o->spike_mag_limit && (spike < -o->spike_mag_limit || spike > o->spike_mag_limit)) o->spike_cnt++;
+        
+        o->position_sure += (uint16_t)delta;
+        
+        o->delta = delta;
+        
+        o->distance += (int32_t)delta;
+        
+        AbsEncoder_velocity_step(o, delta);
+    }
+    else if( (o->spike_mag_limit == 0) || (-o->spike_mag_limit <= check && check <= o->spike_mag_limit))
     {
         int16_t delta = position - o->position_sure;
 
@@ -448,45 +552,46 @@ void AbsEncoder_update(AbsEncoder* o, uint16_t position)
             o->distance += (int32_t)delta;
             
             //o->distance = position;
-                
-            o->velocity = (7*o->velocity + ((int32_t)CTRL_LOOP_FREQUENCY)*o->delta) >> 3;
-        }
-        else
-        {
-            o->velocity = (7*o->velocity) >> 3;
         }
+        
+        AbsEncoder_velocity_step(o, delta);
     }
     else
     {
         o->spike_cnt++;
        
-        o->velocity = (7*o->velocity) >> 3;
+        AbsEncoder_velocity_step(o, 0);
     }
         
     // every second
-    uint64_t iteration = eom_emsrunner_Get_IterationNumber(eom_emsrunner_GetHandle());
-    eOreltime_t period = eom_emsrunner_Get_Period(eom_emsrunner_GetHandle());
-    if ((iteration % period) == 0)
+    if (++o->spike_report_timer >= CTRL_LOOP_FREQUENCY_INT)
     {
-        if (o->spike_cnt > 0)
-        {                
-            //message "spike encoder error"
-            eOerrmanDescriptor_t descriptor = {0};
-            descriptor.par16 = o->ID;           
-            descriptor.par64 = o->spike_cnt;
-            descriptor.sourcedevice = eo_errman_sourcedevice_localboard;
-            descriptor.sourceaddress = 0;
-            descriptor.code = eoerror_code_get(eoerror_category_MotionControl, eoerror_value_MC_aea_abs_enc_spikes);
-            eo_errman_Error(eo_errman_GetHandle(), eo_errortype_warning, NULL, NULL, &descriptor);
-                
-            if (o->spike_cnt > o->spike_cnt_limit)
-            {
-                o->fault_state.bits.spikes = TRUE;
-                o->hardware_fault = TRUE;
-            }
+        o->spike_report_timer = 0;
+        
+        AbsEncoder_spike_report(o);
+    }
+}
+
+static void AbsEncoder_spike_report(AbsEncoder* o)
+{
+    if (o->spike_cnt > 0)
+    {                
+        //message "spike encoder error"
+        eOerrmanDescriptor_t descriptor = {0};
+        descriptor.par16 = o->ID;           
+        descriptor.par64 = o->spike_cnt;
+        descriptor.sourcedevice = eo_errman_sourcedevice_localboard;
+        descriptor.sourceaddress = 0;
+        descriptor.code = eoerror_code_get(eoerror_category_MotionControl, eoerror_value_MC_aea_abs_enc_spikes);
+        eo_errman_Error(eo_errman_GetHandle(), eo_errortype_warning, NULL, NULL, &descriptor);
             
-            o->spike_cnt = 0;
+        if (o->spike_cnt > o->spike_cnt_limit)
+        {
+            o->fault_state.bits.spikes = TRUE;
+            o->hardware_fault = TRUE;
         }
+        
+        o->spike_cnt = 0;
     }
 }
 
@@ -33,6 +33,12 @@ extern "C" {
 /////////////////////////////////////////////////////////
 // AbsEncoder
 
+// the estimator of the velocity
+#define ABS_ENCODER_FILTER_IIR        0 // (7*v + f*delta)/8, the default
+#define ABS_ENCODER_FILTER_ALPHA_BETA 1 // critically damped alpha-beta tracker with configurable bandwidth
+
+#define ABS_ENCODER_MEDIAN_MAX 5
+
 typedef union
 {
     struct
@@ -108,6 +114,15 @@ typedef struct //AbsEncoder
     EncoderFaultState fault_state_prec;
     uint16_t diagnostics_refresh;
     uint16_t count_diagn_mais;
+    uint16_t spike_report_timer;
+    
+    // estimator stage: optional median spike rejection followed by the velocity filter
+    uint8_t filter;
+    uint8_t median;                                // 0 (off), 3 or 5 samples
+    uint16_t window[ABS_ENCODER_MEDIAN_MAX];       // the last raw positions, window[0] is the newest
+    float ab_alpha, ab_beta;
+    float ab_error;                                // estimated position - distance
+    float ab_velocity;
     
 } AbsEncoder;
 
@@ -126,6 +141,10 @@ extern void AbsEncoder_invalid(AbsEncoder* o, eOencoderreader_errortype_t error_
 extern void AbsEncoder_config_resolution(AbsEncoder* o, float resolution);
 extern void AbsEncoder_config_divisor(AbsEncoder* o, int32_t divisor);
 
+// filter is ABS_ENCODER_FILTER_*, median the window of the median spike rejection (0 is the magnitude threshold
+// only), bandwidth [Hz] is used only by the alpha-beta tracker
+extern void AbsEncoder_config_filter(AbsEncoder* o, uint8_t filter, uint8_t median, float bandwidth);
+
 extern void AbsEncoder_timeout(AbsEncoder* o);
 
 extern int32_t AbsEncoder_position(AbsEncoder* o);
@@ -143,6 +143,8 @@ void MController_init() //
     
     o->multi_encs = 1;
     
+    o->actuation.ready = FALSE;
+    
     for (int i=0; i<MAX_JOINTS_PER_BOARD; ++i)
     {
         //o->multi_encs[i] = 1;
@@ -548,6 +550,7 @@ void MController_config_board(const eOmn_serv_configuration_t* brd_cfg)
                 {
                     o->absEncoder[k*2+e].type = eomc_enc_aea;
                     o->absEncoder[k*2+e].fake = FALSE;
+                    AbsEncoder_config_filter(o->absEncoder+k*2+e, AEA_DEFAULT_FILTER, AEA_DEFAULT_MEDIAN, AEA_DEFAULT_BANDWIDTH);
                 }
                 break;
             }
@@ -557,6 +560,7 @@ void MController_config_board(const eOmn_serv_configuration_t* brd_cfg)
                 {
                     o->absEncoder[k*3+e].type = eomc_enc_aea;
                     o->absEncoder[k*3+e].fake = FALSE;
+                    AbsEncoder_config_filter(o->absEncoder+k*3+e, AEA_DEFAULT_FILTER, AEA_DEFAULT_MEDIAN, AEA_DEFAULT_BANDWIDTH);
                 }
                 break;
             }                
@@ -565,6 +569,7 @@ void MController_config_board(const eOmn_serv_configuration_t* brd_cfg)
                 o->joint[k].dead_zone = 9.0f;
                 o->absEncoder[k].type = eomc_enc_aea;
                 o->absEncoder[k].fake = FALSE;
+                AbsEncoder_config_filter(o->absEncoder+k, AEA_DEFAULT_FILTER, AEA_DEFAULT_MEDIAN, AEA_DEFAULT_BANDWIDTH);
                 break;
             }
             
@@ -572,6 +577,7 @@ void MController_config_board(const eOmn_serv_configuration_t* brd_cfg)
             {
                 o->absEncoder[k].type = eomc_enc_mais;
                 o->absEncoder[k].fake = FALSE;
+                AbsEncoder_config_filter(o->absEncoder+k, MAIS_DEFAULT_FILTER, MAIS_DEFAULT_MEDIAN, MAIS_DEFAULT_BANDWIDTH);
                 break;
             }
             
@@ -579,6 +585,7 @@ void MController_config_board(const eOmn_serv_configuration_t* brd_cfg)
             {
                 o->absEncoder[k].type = eomc_enc_absanalog;
                 o->absEncoder[k].fake = FALSE;
+                AbsEncoder_config_filter(o->absEncoder+k, MAIS_DEFAULT_FILTER, MAIS_DEFAULT_MEDIAN, MAIS_DEFAULT_BANDWIDTH);
                 break;
             }
             case eomc_enc_none:
@@ -602,6 +609,7 @@ void MController_config_board(const eOmn_serv_configuration_t* brd_cfg)
             
             case HARDWARE_2FOC:
                 o->motor[k].actuatorPort = jomodes->actuator.foc.canloc.addr-1;
+                o->motor[k].actuatorCANport = jomodes->actuator.foc.canloc.port;
                 break;
 
             default:
@@ -611,6 +619,7 @@ void MController_config_board(const eOmn_serv_configuration_t* brd_cfg)
         o->joint[k].eo_joint_ptr = eo_entities_GetJoint(eo_entities_GetHandle(), k);
     }
     
+    Motor_plan_actuation(&o->actuation, o->motor, o->nJoints);
     
     get_jomo_coupling_info(jomoCouplingInfo, carray);
     
@@ -1580,7 +1589,7 @@ void MController_do()
         JointSet_do(smc->jointSet+s);
     }
     
-    Motor_actuate(smc->motor, smc->nJoints);
+    Motor_actuate(smc->motor, smc->nJoints, &smc->actuation);
 }
 
 BOOL MController_set_control_mode(uint8_t j, eOmc_controlmode_command_t control_mode) //
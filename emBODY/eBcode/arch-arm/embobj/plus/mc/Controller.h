@@ -57,6 +57,8 @@ typedef struct //MController
     Motor *motor;
     Joint *joint;
     
+    MotorActuationPlan actuation;
+    
     float **Jjm;
     float **Jmj;
     
@@ -52,6 +52,16 @@ extern "C" {
     
 #define MAIS_DEFAULT_SPIKE_MAG_LIMIT   112 // 7*16 = 7*65536/resolution 
 #define MAIS_DEFAULT_SPIKE_CNT_LIMIT 32767 // no hardware error on spikes
+
+// the estimator stage of AbsEncoder for each type of encoder (see AbsEncoder_config_filter()). 
+// ABS_ENCODER_FILTER_IIR with median 0 is the legacy filter
+#define AEA_DEFAULT_FILTER          ABS_ENCODER_FILTER_ALPHA_BETA
+#define AEA_DEFAULT_MEDIAN          3
+#define AEA_DEFAULT_BANDWIDTH       40.0f // Hz
+
+#define MAIS_DEFAULT_FILTER         ABS_ENCODER_FILTER_IIR
+#define MAIS_DEFAULT_MEDIAN         0
+#define MAIS_DEFAULT_BANDWIDTH      0.0f
     
 #define CTRL_LOOP_FREQUENCY_INT 1000  
 #define CTRL_LOOP_FREQUENCY  1000.0f
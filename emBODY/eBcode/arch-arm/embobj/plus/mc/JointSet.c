@@ -35,6 +35,13 @@
 #include "Calibrators.h"
 
 static void JointSet_set_inner_control_flags(JointSet* o);
+static void JointSet_compile_coupling(JointSet* o);
+static void JointSet_mat_vec(const float* M, const float* x, float* y, int rows, int cols);
+static float JointSet_invert(const float* M, float* I, int n);
+static float JointSet_norm1(const float* M, int n);
+
+// beyond this condition number a float inverse of the coupling loses more than three significant digits
+#define JOINTSET_MAX_COUPLING_CONDITION 1.0e4f
 
 JointSet* JointSet_new(uint8_t n) //
 {
@@ -65,6 +72,9 @@ void JointSet_init(JointSet* o) //
     o->Sje = NULL;
     o->Sjm = NULL;
     
+    o->coupling.N = 0;
+    o->coupling.E = 0;
+    
     o->absEncoder = NULL;
     
     o->control_mode     = eomc_controlmode_notConfigured;
@@ -114,6 +124,215 @@ void JointSet_config //
     o->Jmj = Jmj;
     o->Sje = Sje;
     o->Sjm = Sjm;
+    
+    JointSet_compile_coupling(o);
+}
+
+static void JointSet_compile_coupling(JointSet* o)
+{
+    JointSetCoupling* c = &o->coupling;
+    
+    int N = *(o->pN);
+    int E = *(o->pE);
+    
+    c->N = N;
+    c->E = E;
+    
+    for (int js=0; js<N; ++js)
+    {
+        int j = o->joints_of_set[js];
+        
+        for (int ms=0; ms<N; ++ms)
+        {
+            int m = o->motors_of_set[ms];
+            
+            c->Sjm [js*N+ms] = o->Sjm ? o->Sjm[j][m] : ZERO;
+            c->JjmT[ms*N+js] = o->Jjm ? o->Jjm[j][m] : ZERO;
+            c->Jmj [ms*N+js] = o->Jmj ? o->Jmj[m][j] : ZERO;
+            c->JmjT[js*N+ms] = o->Jmj ? o->Jmj[m][j] : ZERO;
+        }
+        
+        for (int es=0; es<E; ++es)
+        {
+            int e = o->encoders_of_set[es];
+            
+            c->Sje[js*E+es] = o->Sje ? o->Sje[j][e] : ZERO;
+        }
+    }
+    
+    // the inverse of the coupling is computed once here, at configuration time. the configuration gives it as 
+    // joint2motor, which is the one used by the control loop, so we only check that it is consistent.
+    if (o->Sjm && o->Jmj)
+    {
+        float inv[MAX_JOINTS_PER_BOARD*MAX_JOINTS_PER_BOARD];
+        
+        float cond = JointSet_invert(c->Sjm, inv, N);
+        
+        if (cond == ZERO)
+        {
+            JointSet_send_debug_message("singular motor2joint coupling", o->joints_of_set[0]);
+            return;
+        }
+        
+        if (cond > JOINTSET_MAX_COUPLING_CONDITION)
+        {
+            JointSet_send_debug_message("ill-conditioned motor2joint coupling", o->joints_of_set[0]);
+        }
+        
+        float tol = 1.0e-3f*JointSet_norm1(inv, N);
+        
+        for (int k=0; k<N*N; ++k)
+        {
+            float d = inv[k] - c->Jmj[k];
+            
+            if (d > tol || d < -tol)
+            {
+                JointSet_send_debug_message("joint2motor is not the inverse of motor2joint", o->joints_of_set[0]);
+                break;
+            }
+        }
+    }
+}
+
+// the 1-norm (max column sum) of a n x n block
+static float JointSet_norm1(const float* M, int n)
+{
+    float norm = ZERO;
+    
+    for (int c=0; c<n; ++c)
+    {
+        float sum = ZERO;
+        
+        for (int r=0; r<n; ++r)
+        {
+            float a = M[r*n+c];
+            
+            sum += (a < ZERO) ? -a : a;
+        }
+        
+        if (sum > norm) norm = sum;
+    }
+    
+    return norm;
+}
+
+// the inverse of the n x n block M in I with gauss-jordan and partial pivoting. it returns the 1-norm condition
+// number of M, or ZERO if M is singular (I is then undefined).
+static float JointSet_invert(const float* M, float* I, int n)
+{
+    float B[MAX_JOINTS_PER_BOARD*MAX_JOINTS_PER_BOARD];
+    
+    for (int k=0; k<n*n; ++k)
+    {
+        B[k] = M[k];
+        I[k] = ZERO;
+    }
+    
+    for (int k=0; k<n; ++k) I[k*n+k] = 1.0f;
+    
+    float scale = JointSet_norm1(M, n);
+    
+    if (scale == ZERO) return ZERO;
+    
+    for (int r=0; r<n; ++r)
+    {
+        int pivot = r;
+        float max = ZERO;
+        
+        for (int d=r; d<n; ++d)
+        {
+            float a = B[d*n+r];
+            
+            if (a < ZERO) a = -a;
+            
+            if (a > max)
+            {
+                max = a;
+                pivot = d;
+            }
+        }
+        
+        if (max <= 1.0e-7f*scale) return ZERO;
+        
+        if (pivot != r)
+        {
+            for (int c=0; c<n; ++c)
+            {
+                float tb = B[r*n+c]; B[r*n+c] = B[pivot*n+c]; B[pivot*n+c] = tb;
+                float ti = I[r*n+c]; I[r*n+c] = I[pivot*n+c]; I[pivot*n+c] = ti;
+            }
+        }
+        
+        float P = 1.0f/B[r*n+r];
+        
+        for (int c=0; c<n; ++c)
+        {
+            B[r*n+c] *= P;
+            I[r*n+c] *= P;
+        }
+        
+        for (int rr=0; rr<n; ++rr) if (rr != r)
+        {
+            float D = B[rr*n+r];
+            
+            for (int c=0; c<n; ++c)
+            {
+                B[rr*n+c] -= D*B[r*n+c];
+                I[rr*n+c] -= D*I[r*n+c];
+            }
+        }
+    }
+    
+    return scale*JointSet_norm1(I, n);
+}
+
+// y = M*x, with M dense row major. the square blocks of the sets (N = 1..4) are unrolled so that the 
+// products stay in the registers of the fpu and become multiply-accumulates. the sums keep the order 
+// of the original loops.
+static void JointSet_mat_vec(const float* M, const float* x, float* y, int rows, int cols)
+{
+    if (rows == cols)
+    {
+        switch (rows)
+        {
+            case 1:
+                y[0] = M[0]*x[0];
+                return;
+            
+            case 2:
+                y[0] = M[0]*x[0] + M[1]*x[1];
+                y[1] = M[2]*x[0] + M[3]*x[1];
+                return;
+            
+            case 3:
+                y[0] = M[0]*x[0] + M[1]*x[1] + M[2]*x[2];
+                y[1] = M[3]*x[0] + M[4]*x[1] + M[5]*x[2];
+                y[2] = M[6]*x[0] + M[7]*x[1] + M[8]*x[2];
+                return;
+            
+            case 4:
+                y[0] = M[ 0]*x[0] + M[ 1]*x[1] + M[ 2]*x[2] + M[ 3]*x[3];
+                y[1] = M[ 4]*x[0] + M[ 5]*x[1] + M[ 6]*x[2] + M[ 7]*x[3];
+                y[2] = M[ 8]*x[0] + M[ 9]*x[1] + M[10]*x[2] + M[11]*x[3];
+                y[3] = M[12]*x[0] + M[13]*x[1] + M[14]*x[2] + M[15]*x[3];
+                return;
+            
+            default:
+                break;
+        }
+    }
+    
+    for (int r=0; r<rows; ++r)
+    {
+        float acc = ZERO;
+        
+        for (int k=0; k<cols; ++k)
+        {
+            acc += M[r*cols+k]*x[k];
+        }
+        
+        y[r] = acc;
+    }
 }
 
 void JointSet_do_odometry(JointSet* o) //
@@ -122,25 +341,33 @@ void JointSet_do_odometry(JointSet* o) //
     int ms, m;
 
     int N = *(o->pN);
-            
-    float **Sjm = o->Sjm;
     
-    if (Sjm)
+    const JointSetCoupling* c = &o->coupling;
+    
+    if (o->Sjm)
     {
+        float motor_pos[MAX_MOTORS_PER_BOARD];
+        float motor_vel[MAX_MOTORS_PER_BOARD];
+        float joint_pos[MAX_JOINTS_PER_BOARD];
+        float joint_vel[MAX_JOINTS_PER_BOARD];
+        
+        for (ms=0; ms<N; ++ms)
+        {
+            m = o->motors_of_set[ms];
+            
+            motor_pos[ms] = o->motor[m].pos_fbk;
+            motor_vel[ms] = o->motor[m].vel_fbk;
+        }
+        
+        JointSet_mat_vec(c->Sjm, motor_pos, joint_pos, N, N);
+        JointSet_mat_vec(c->Sjm, motor_vel, joint_vel, N, N);
+        
         for (js=0; js<N; ++js)
         {
             j = o->joints_of_set[js];
 
-            o->joint[j].pos_fbk_from_motors = ZERO;
-            o->joint[j].vel_fbk_from_motors = ZERO;
-            
-            for (ms=0; ms<N; ++ms)
-            {
-                m = o->motors_of_set[ms];
-        
-                o->joint[j].pos_fbk_from_motors += Sjm[j][m] * o->motor[m].pos_fbk;
-                o->joint[j].vel_fbk_from_motors += Sjm[j][m] * o->motor[m].vel_fbk;
-            }
+            o->joint[j].pos_fbk_from_motors = joint_pos[js];
+            o->joint[j].vel_fbk_from_motors = joint_vel[js];
         }
     }
     else
@@ -187,8 +414,11 @@ void JointSet_do_odometry(JointSet* o) //
     {
         int E = *(o->pE);
         
+        // in the local indices of the set
         float pos[MAX_ENCODS_PER_BOARD];
         float vel[MAX_ENCODS_PER_BOARD];
+        float joint_pos[MAX_JOINTS_PER_BOARD];
+        float joint_vel[MAX_JOINTS_PER_BOARD];
         
         int es, e;
         
@@ -198,40 +428,33 @@ void JointSet_do_odometry(JointSet* o) //
             
             if (AbsEncoder_is_fake(o->absEncoder+e))
             {
-                pos[e] = o->joint[e].pos_fbk_from_motors;
-                vel[e] = o->joint[e].vel_fbk_from_motors;
+                pos[es] = o->joint[e].pos_fbk_from_motors;
+                vel[es] = o->joint[e].vel_fbk_from_motors;
             }
             else
             {
-                pos[e] = AbsEncoder_position(o->absEncoder+e);
+                pos[es] = AbsEncoder_position(o->absEncoder+e);
                 
                 if (o->USE_SPEED_FBK_FROM_MOTORS)
                 {
-                    vel[e] = o->joint[e].vel_fbk_from_motors;
+                    vel[es] = o->joint[e].vel_fbk_from_motors;
                 }
                 else
                 {
-                    vel[e] = AbsEncoder_velocity(o->absEncoder+e);
+                    vel[es] = AbsEncoder_velocity(o->absEncoder+e);
                 }
             }
         }
-    
-        float **Sje = o->Sje;
+        
+        JointSet_mat_vec(c->Sje, pos, joint_pos, N, E);
+        JointSet_mat_vec(c->Sje, vel, joint_vel, N, E);
         
         for (js=0; js<N; ++js)
         {
             j = o->joints_of_set[js];
         
-            o->joint[j].pos_fbk = ZERO;
-            o->joint[j].vel_fbk = ZERO;
-            
-            for (es=0; es<E; ++es)
-            {
-                e = o->encoders_of_set[es];
-                
-                o->joint[j].pos_fbk += Sje[j][e] * pos[e];
-                o->joint[j].vel_fbk += Sje[j][e] * vel[e];
-            }
+            o->joint[j].pos_fbk = joint_pos[js];
+            o->joint[j].vel_fbk = joint_vel[js];
         }
     }
 }
@@ -553,113 +776,129 @@ void JointSet_do_pwm_control(JointSet* o)
         }
     }
     
-    CTRL_UNITS motor_pwm_ref = ZERO;
+    const JointSetCoupling* c = &o->coupling;
     
-    for (int ms=0; ms<N; ++ms)
-    {
-        int m = o->motors_of_set[ms];
+    // the vectors in the local indices of the set
+    float joint_vec[MAX_JOINTS_PER_BOARD];
+    float joint_vec2[MAX_JOINTS_PER_BOARD];
+    float motor_vec[MAX_MOTORS_PER_BOARD];
+    float motor_vec2[MAX_MOTORS_PER_BOARD];
     
-        if (o->trq_control_active)
-        {   
-            if (o->Jjm)
+    if (o->trq_control_active)
+    {   
+        if (o->Jjm)
+        {
+            for (int js=0; js<N; ++js)
             {
-                CTRL_UNITS motor_trq_ref = ZERO;
-                CTRL_UNITS motor_trq_fbk = ZERO;
-            
-                for (int js=0; js<N; ++js)
-                {
-                    int j = o->joints_of_set[js];
-                
-                    // mu = Jt Tau 
-                    // transposed direct Jacobian
-                    motor_trq_ref += o->Jjm[j][m]*o->joint[j].trq_ref;
-                    motor_trq_fbk += o->Jjm[j][m]*o->joint[j].trq_fbk;
-                }
+                int j = o->joints_of_set[js];
                 
-                motor_pwm_ref = Motor_do_trq_control(o->motor+m, motor_trq_ref, motor_trq_fbk);
+                joint_vec [js] = o->joint[j].trq_ref;
+                joint_vec2[js] = o->joint[j].trq_fbk;
             }
-            else
+            
+            // mu = Jt Tau 
+            // transposed direct Jacobian
+            JointSet_mat_vec(c->JjmT, joint_vec,  motor_vec,  N, N);
+            JointSet_mat_vec(c->JjmT, joint_vec2, motor_vec2, N, N);
+            
+            for (int ms=0; ms<N; ++ms)
             {
-                motor_pwm_ref = Motor_do_trq_control(o->motor+m, o->joint[m].trq_ref, o->joint[m].trq_fbk);
+                int m = o->motors_of_set[ms];
+                
+                Motor_set_pwm_ref(o->motor+m, Motor_do_trq_control(o->motor+m, motor_vec[ms], motor_vec2[ms]));
             }
         }
         else
         {
-            if (o->Jmj)
+            for (int ms=0; ms<N; ++ms)
             {
-                motor_pwm_ref = ZERO;
-            
-                for (int js=0; js<N; ++js)
-                {
-                    int j = o->joints_of_set[js];
+                int m = o->motors_of_set[ms];
                 
-                    // inverse Jacobian
-                    motor_pwm_ref += o->Jmj[m][j]*o->joint[j].output;
-                }
+                Motor_set_pwm_ref(o->motor+m, Motor_do_trq_control(o->motor+m, o->joint[m].trq_ref, o->joint[m].trq_fbk));
             }
-            else
+        }
+    }
+    else
+    {
+        if (o->Jmj)
+        {
+            for (int js=0; js<N; ++js)
+            {
+                joint_vec[js] = o->joint[o->joints_of_set[js]].output;
+            }
+            
+            // inverse Jacobian
+            JointSet_mat_vec(c->Jmj, joint_vec, motor_vec, N, N);
+            
+            for (int ms=0; ms<N; ++ms)
             {
-                motor_pwm_ref = o->joint[m].output;
+                Motor_set_pwm_ref(o->motor+o->motors_of_set[ms], motor_vec[ms]);
+            }
+        }
+        else
+        {
+            for (int ms=0; ms<N; ++ms)
+            {
+                int m = o->motors_of_set[ms];
+                
+                Motor_set_pwm_ref(o->motor+m, o->joint[m].output);
             }
         }
-
-        Motor_set_pwm_ref(o->motor+m, motor_pwm_ref);
     }
     
     if (limits_torque_protection)
     {
         CTRL_UNITS joint_pwm_ref[MAX_JOINTS_PER_BOARD];
         
-        for (int js=0; js<N; ++js)
+        if (o->Jmj)
         {
-            int j = o->joints_of_set[js];
-            
-            if (o->Jmj)
+            for (int ms=0; ms<N; ++ms)
             {
-                joint_pwm_ref[j] = ZERO;
-            
-                for (int ms=0; ms<N; ++ms)
-                {
-                    int m = o->motors_of_set[ms];
-                
-                    // transposed inverse Jacobian
-                    joint_pwm_ref[j] += o->Jmj[m][j]*o->motor[m].pwm_ref;
-                }
+                motor_vec[ms] = o->motor[o->motors_of_set[ms]].pwm_ref;
             }
-            else
+            
+            // transposed inverse Jacobian
+            JointSet_mat_vec(c->JmjT, motor_vec, joint_vec, N, N);
+        }
+        else
+        {
+            for (int js=0; js<N; ++js)
             {
-                joint_pwm_ref[j] = o->motor[j].pwm_ref;
+                joint_vec[js] = o->motor[o->joints_of_set[js]].pwm_ref;
             }
+        }
+        
+        for (int js=0; js<N; ++js)
+        {
+            int j = o->joints_of_set[js];
             
             if (Joint_pushing_limit(o->joint+j))
             {
-                if ((o->joint[j].output_lim > ZERO) ^ (o->joint[j].output_lim < joint_pwm_ref[j]))
+                if ((o->joint[j].output_lim > ZERO) ^ (o->joint[j].output_lim < joint_vec[js]))
                 {
-                    joint_pwm_ref[j] = o->joint[j].output_lim; 
+                    joint_vec[js] = o->joint[j].output_lim; 
                 }
             }
+            
+            joint_pwm_ref[j] = joint_vec[js];
         }
         
-        for (int ms=0; ms<N; ++ms)
+        if (o->Jjm)
         {
-            int m = o->motors_of_set[ms];
-        
-            if (o->Jjm)
-            {
-                motor_pwm_ref = ZERO;
+            // transposed jacobian
+            JointSet_mat_vec(c->JjmT, joint_vec, motor_vec, N, N);
             
-                for (int js=0; js<N; ++js)
-                {
-                    int j = o->joints_of_set[js];
-                
-                    // transposed jacobian
-                    motor_pwm_ref += o->Jjm[j][m]*joint_pwm_ref[j];
-                }
-            
-                Motor_set_pwm_ref(o->motor+m, motor_pwm_ref);
+            for (int ms=0; ms<N; ++ms)
+            {
+                Motor_set_pwm_ref(o->motor+o->motors_of_set[ms], motor_vec[ms]);
             }
-            else
+        }
+        else
+        {
+            for (int ms=0; ms<N; ++ms)
             {
+                int m = o->motors_of_set[ms];
+                
                 Motor_set_pwm_ref(o->motor+m, joint_pwm_ref[m]);
             }
         }
@@ -689,27 +928,30 @@ static void JointSet_do_vel_control(JointSet* o)
         Joint_do_vel_control(o->joint+o->joints_of_set[js]);
     }
     
-    for (int ms=0; ms<N; ++ms)
+    if (o->Jmj)
     {
-        int m = o->motors_of_set[ms];
-    
-        if (o->Jmj)
+        float joint_vec[MAX_JOINTS_PER_BOARD];
+        float motor_vec[MAX_MOTORS_PER_BOARD];
+        
+        for (int js=0; js<N; ++js)
         {
-            float **Ji = o->Jmj; // inverse Jacobian
-            
-            CTRL_UNITS motor_vel_ref = ZERO;
+            joint_vec[js] = o->joint[o->joints_of_set[js]].output;
+        }
         
-            for (int js=0; js<N; ++js)
-            {
-                int j = o->joints_of_set[js];
-                
-                motor_vel_ref += Ji[m][j]*o->joint[j].output;
-            }
+        // inverse Jacobian
+        JointSet_mat_vec(o->coupling.Jmj, joint_vec, motor_vec, N, N);
         
-            Motor_set_vel_ref(o->motor+m, motor_vel_ref);
+        for (int ms=0; ms<N; ++ms)
+        {
+            Motor_set_vel_ref(o->motor+o->motors_of_set[ms], motor_vec[ms]);
         }
-        else
+    }
+    else
+    {
+        for (int ms=0; ms<N; ++ms)
         {
+            int m = o->motors_of_set[ms];
+            
             Motor_set_vel_ref(o->motor+m, o->joint[m].output);
         }
     }
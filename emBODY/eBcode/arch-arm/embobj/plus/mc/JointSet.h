@@ -37,6 +37,21 @@ extern "C" {
 #include "hal_led.h"
 
 
+// the coupling matrices of a set, compiled by JointSet_config() in the local indices of the set (js, ms, es):
+// dense row-major blocks with the permutation of joints_of_set / motors_of_set / encoders_of_set already applied, 
+// so that the control loop does not gather through the float** rows of MController.
+typedef struct // JointSetCoupling
+{
+    uint8_t N;  // joints and motors of the set
+    uint8_t E;  // encoders of the set
+    
+    float Sjm [MAX_JOINTS_PER_BOARD*MAX_MOTORS_PER_BOARD]; // [js][ms]
+    float JjmT[MAX_MOTORS_PER_BOARD*MAX_JOINTS_PER_BOARD]; // [ms][js]
+    float Jmj [MAX_MOTORS_PER_BOARD*MAX_JOINTS_PER_BOARD]; // [ms][js]
+    float JmjT[MAX_JOINTS_PER_BOARD*MAX_MOTORS_PER_BOARD]; // [js][ms]
+    float Sje [MAX_JOINTS_PER_BOARD*MAX_ENCODS_PER_BOARD]; // [js][es]
+} JointSetCoupling;
+
 typedef struct // JointSet
 {
     hal_led_t led;
@@ -57,6 +72,8 @@ typedef struct // JointSet
     float** Sje;
     float** Sjm;
     
+    JointSetCoupling coupling;
+    
     uint32_t calibration_wait;
     
     AbsEncoder* absEncoder;
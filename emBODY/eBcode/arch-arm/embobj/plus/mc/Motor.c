@@ -809,10 +809,68 @@ void Motor_update_state_fbk(Motor* o, void* state) //
     */
 }
 
-void Motor_actuate(Motor* motor, uint8_t N) //
+void Motor_plan_actuation(MotorActuationPlan* plan, Motor* motor, uint8_t N)
+{
+    plan->ready = FALSE;
+    
+    for (int p=0; p<eOcanports_number; ++p)
+    {
+        plan->used[p] = FALSE;
+    }
+    
+    if (motor->HARDWARE_TYPE != HARDWARE_2FOC) return;
+    
+    int16_t zero[MAX_MOTORS_PER_BOARD] = {0};
+    
+    eOcanprot_command_t command = {0};
+    command.clas = eocanprot_msgclass_periodicMotorControl;    
+    command.type  = ICUBCANPROTO_PER_MC_MSG__EMSTO2FOC_DESIRED_CURRENT;
+    command.value = zero;
+    
+    for (int m=0; m<N; ++m)
+    {
+        uint8_t port = motor[m].actuatorCANport;
+        
+        if ((port >= eOcanports_number) || (motor[m].actuatorPort >= MAX_MOTORS_PER_BOARD)) return;
+        
+        plan->port[m] = port;
+        plan->slot[m] = motor[m].actuatorPort;
+        
+        if (plan->used[port]) continue;
+        
+        eObrd_canlocation_t location = {0};
+        location.port = port;
+        location.addr = 0;
+        location.insideindex = eobrd_caninsideindex_first; // because all 2foc have motor on index-0. 
+        
+        if (eores_OK != eo_canserv_FormFrame(eo_canserv_GetHandle(), &command, location, &plan->frame[port])) return;
+        
+        plan->used[port] = TRUE;
+    }
+    
+    plan->ready = TRUE;
+}
+
+void Motor_actuate(Motor* motor, uint8_t N, MotorActuationPlan* plan) //
 {
     if (motor->HARDWARE_TYPE == HARDWARE_2FOC)
     {
+        if (plan && plan->ready)
+        {
+            for (int m=0; m<N; ++m)
+            {
+                // the same layout of the former of ICUBCANPROTO_PER_MC_MSG__EMSTO2FOC_DESIRED_CURRENT
+                ((int16_t*)plan->frame[plan->port[m]].data)[plan->slot[m]] = motor[m].output;
+            }
+            
+            for (int p=0; p<eOcanports_number; ++p)
+            {
+                if (plan->used[p]) eo_canserv_SendFrame(eo_canserv_GetHandle(), (eOcanport_t)p, &plan->frame[p]);
+            }
+            
+            return;
+        }
+        
         int16_t output[MAX_JOINTS_PER_BOARD];
     
         for (int m=0; m<N; ++m)
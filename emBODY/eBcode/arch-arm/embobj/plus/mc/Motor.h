@@ -145,6 +145,7 @@ typedef struct //Motor
     // consts
     uint8_t ID;
     uint8_t actuatorPort;
+    uint8_t actuatorCANport;
 
     // UNKNOWN              0
     // HARDWARE_2FOC        1
@@ -263,7 +264,20 @@ extern void Motor_update_state_fbk(Motor* o, void* state_msg); //
 extern void Motor_update_odometry_fbk_can(Motor* o, CanOdometry2FocMsg* data); //
 extern void Motor_do_calibration_hard_stop(Motor* o); //
 
-extern void Motor_actuate(Motor* o, uint8_t N); //
+// the desired currents of the 2FOC boards travel in one broadcast frame per can port, with an int16 slot for each
+// can address. Motor_plan_actuation() forms the frames once at configuration, so that Motor_actuate() only has to
+// patch their payload and put them in the tx queues.
+typedef struct //MotorActuationPlan
+{
+    BOOL ready;
+    BOOL used[eOcanports_number];
+    eOcanframe_t frame[eOcanports_number];
+    uint8_t port[MAX_MOTORS_PER_BOARD];
+    uint8_t slot[MAX_MOTORS_PER_BOARD];
+} MotorActuationPlan;
+
+extern void Motor_plan_actuation(MotorActuationPlan* plan, Motor* o, uint8_t N);
+extern void Motor_actuate(Motor* o, uint8_t N, MotorActuationPlan* plan); //
 
 extern void Motor_set_pwm_ref(Motor* o, int32_t pwm_ref);
 extern void Motor_set_Iqq_ref(Motor* o, int32_t Iqq_ref);
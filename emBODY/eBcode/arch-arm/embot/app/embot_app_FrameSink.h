@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * Author:  agent
+ * email:   agent@local
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+// - include guard ----------------------------------------------------------------------------------------------------
+
+#ifndef _EMBOT_APP_FRAMESINK_H_
+#define _EMBOT_APP_FRAMESINK_H_
+
+#include "embot_common.h"
+
+#include "embot_hw.h"
+
+#include <cstring>
+
+
+namespace embot { namespace app {
+
+    // it is where the parsers and the periodic objects of embot::app (theSkin, theIMU, theCANtracer, etc.) put the
+    // can frames they want to transmit. it replaces std::vector<embot::hw::can::Frame> so that no heap is used at runtime.
+    // the memory is given by a derived FrameStore<N>, whereas the functions accept a FrameSink & so that
+    // they do not depend on N.
+    // when full, push() behaves according to the policy:
+    // - OverflowPolicy::dropNewest: the frame is refused.
+    // - OverflowPolicy::dropOldest: the first frame is removed and the new one is appended.
+    // in both cases the lost frame is counted in dropped().
+
+    class FrameSink
+    {
+    public:
+
+        bool push(const embot::hw::can::Frame &frame)
+        {
+            if(num >= cap)
+            {
+                lost++;
+                if((embot::common::OverflowPolicy::dropNewest == policy) || (0 == cap))
+                {
+                    return false;
+                }
+                std::memmove(&frames[0], &frames[1], (cap-1)*sizeof(embot::hw::can::Frame));
+                num = cap - 1;
+            }
+            frames[num++] = frame;
+            return true;
+        }
+
+        void clear() { num = 0; }
+
+        bool full() const { return (num >= cap); }
+        bool empty() const { return (0 == num); }
+        std::uint8_t size() const { return num; }
+        std::uint8_t capacity() const { return cap; }
+        std::uint32_t dropped() const { return lost; }
+        void resetdropped() { lost = 0; }
+
+        // the frames in [data(), data()+size())
+        const embot::hw::can::Frame * data() const { return frames; }
+        const embot::hw::can::Frame & operator[](std::uint8_t i) const { return frames[i]; }
+
+        void setpolicy(embot::common::OverflowPolicy p) { policy = p; }
+
+    protected:
+
+        FrameSink(embot::hw::can::Frame *f, std::uint8_t c) : frames(f), cap(c), num(0), policy(embot::common::OverflowPolicy::dropNewest), lost(0) {}
+
+    public:
+        // remove copy constructors and copy assignment operators: the memory belongs to the FrameStore<>
+        FrameSink(const FrameSink&) = delete;
+        FrameSink(FrameSink&) = delete;
+        void operator=(const FrameSink&) = delete;
+        void operator=(FrameSink&) = delete;
+
+    private:
+
+        embot::hw::can::Frame           *frames;
+        std::uint8_t                    cap;
+        std::uint8_t                    num;
+        embot::common::OverflowPolicy   policy;
+        std::uint32_t                   lost;
+    };
+
+
+    template<std::uint8_t N>
+    class FrameStore : public FrameSink
+    {
+    public:
+        FrameStore() : FrameSink(storage, N) {}
+
+    private:
+        embot::hw::can::Frame storage[N];
+    };
+
+
+}} // namespace embot { namespace app {
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
+
@@ -129,28 +129,29 @@ struct embot::app::application::theCANparserBasic::Impl
         {
             canbrdinfo.setCANaddress(target);
             canaddress = canbrdinfo.getCANaddress();
+            embot::app::canprotocol::changeClassFilterAddress(canaddress);
         }
         
         return (target == canaddress);
     }
     
     
-    bool process(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
+    bool process(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
     
-    bool process_bl_broadcast_appl(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);  
-    bool process_bl_board_appl(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);    
-    bool process_bl_getadditionalinfo(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
-    bool process_bl_setadditionalinfo(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
-    bool process_bl_setcanaddress(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
+    bool process_bl_broadcast_appl(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);  
+    bool process_bl_board_appl(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);    
+    bool process_bl_getadditionalinfo(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
+    bool process_bl_setadditionalinfo(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
+    bool process_bl_setcanaddress(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
     
-    bool process_getfirmwareversion(const embot::app::canprotocol::Clas cl, const std::uint8_t cm, const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);    
-    bool process_setid(const embot::app::canprotocol::Clas cl, const std::uint8_t cm, const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
+    bool process_getfirmwareversion(const embot::app::canprotocol::Clas cl, const std::uint8_t cm, const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);    
+    bool process_setid(const embot::app::canprotocol::Clas cl, const std::uint8_t cm, const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
     
         
 };
 
 
-bool embot::app::application::theCANparserBasic::Impl::process(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserBasic::Impl::process(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     txframe = false;
     recognised = false;
@@ -251,7 +252,7 @@ bool embot::app::application::theCANparserBasic::Impl::process(const embot::hw::
 
 
 
-bool embot::app::application::theCANparserBasic::Impl::process_bl_broadcast_appl(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserBasic::Impl::process_bl_broadcast_appl(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_bldr_BROADCAST msg;
     msg.load(frame);
@@ -269,7 +270,7 @@ bool embot::app::application::theCANparserBasic::Impl::process_bl_broadcast_appl
         
     if(true == msg.reply(reply, canaddress, replyinfo))
     {
-        replies.push_back(reply);
+        replies.push(reply);
         return true;
     }        
     
@@ -277,7 +278,7 @@ bool embot::app::application::theCANparserBasic::Impl::process_bl_broadcast_appl
 }
 
 
-bool embot::app::application::theCANparserBasic::Impl::process_bl_board_appl(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserBasic::Impl::process_bl_board_appl(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_bldr_BOARD msg;
     msg.load(frame);
@@ -289,7 +290,7 @@ bool embot::app::application::theCANparserBasic::Impl::process_bl_board_appl(con
 }
 
 
-bool embot::app::application::theCANparserBasic::Impl::process_bl_getadditionalinfo(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserBasic::Impl::process_bl_getadditionalinfo(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_bldr_GET_ADDITIONAL_INFO msg;
     msg.load(frame);
@@ -306,7 +307,7 @@ bool embot::app::application::theCANparserBasic::Impl::process_bl_getadditionali
     {
         if(true == msg.reply(reply, canaddress, replyinfo))
         {
-            replies.push_back(reply);
+            replies.push(reply);
         }
     }
     return true;
@@ -314,7 +315,7 @@ bool embot::app::application::theCANparserBasic::Impl::process_bl_getadditionali
 }
 
 
-bool embot::app::application::theCANparserBasic::Impl::process_bl_setadditionalinfo(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserBasic::Impl::process_bl_setadditionalinfo(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_bldr_SET_ADDITIONAL_INFO2 msg;
     msg.load(frame);
@@ -331,7 +332,7 @@ bool embot::app::application::theCANparserBasic::Impl::process_bl_setadditionali
 }
 
 
-bool embot::app::application::theCANparserBasic::Impl::process_setid(const embot::app::canprotocol::Clas cl, const std::uint8_t cm, const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserBasic::Impl::process_setid(const embot::app::canprotocol::Clas cl, const std::uint8_t cm, const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_base_SET_ID msg(cl, cm);
     msg.load(frame);
@@ -341,7 +342,7 @@ bool embot::app::application::theCANparserBasic::Impl::process_setid(const embot
     return msg.reply();        
 }
 
-bool embot::app::application::theCANparserBasic::Impl::process_getfirmwareversion(const embot::app::canprotocol::Clas cl, const std::uint8_t cm, const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserBasic::Impl::process_getfirmwareversion(const embot::app::canprotocol::Clas cl, const std::uint8_t cm, const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     
     embot::app::canprotocol::Message_base_GET_FIRMWARE_VERSION msg(cl, cm);
@@ -355,14 +356,14 @@ bool embot::app::application::theCANparserBasic::Impl::process_getfirmwareversio
     
     if(true == msg.reply(reply, canaddress, replyinfo))
     {            
-        replies.push_back(reply);
+        replies.push(reply);
         return true;
     }
     
     return false;
 }
 
-bool embot::app::application::theCANparserBasic::Impl::process_bl_setcanaddress(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserBasic::Impl::process_bl_setcanaddress(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_bldr_SETCANADDRESS msg;
     msg.load(frame);
@@ -408,6 +409,11 @@ bool embot::app::application::theCANparserBasic::initialise(Config &config)
         pImpl->canprotocol.minor = storedinfo.protocolVminor;
         pImpl->board = static_cast<embot::app::canprotocol::Board>(storedinfo.boardtype);        
     }
+    
+    // we let the hw discard what we would reject anyway in process()
+    embot::app::canprotocol::addClassFilter(embot::app::canprotocol::Clas::bootloader, pImpl->canaddress);
+    embot::app::canprotocol::addClassFilter(embot::app::canprotocol::Clas::pollingMotorControl, pImpl->canaddress);
+    embot::app::canprotocol::addClassFilter(embot::app::canprotocol::Clas::pollingAnalogSensor, pImpl->canaddress);
       
     
     return true;
@@ -415,7 +421,7 @@ bool embot::app::application::theCANparserBasic::initialise(Config &config)
   
 
 
-bool embot::app::application::theCANparserBasic::process(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserBasic::process(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {    
     return pImpl->process(frame, replies);
 }
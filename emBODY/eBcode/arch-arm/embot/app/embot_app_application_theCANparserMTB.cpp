@@ -72,18 +72,18 @@ struct embot::app::application::theCANparserMTB::Impl
     }
     
    
-    bool process(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
+    bool process(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
     
     
-    bool process_set_brdcfg(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);   
-    bool process_set_trgcfg(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);      
-    bool process_set_txmode(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
-    bool process_set_accgyrosetup(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
+    bool process_set_brdcfg(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);   
+    bool process_set_trgcfg(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);      
+    bool process_set_txmode(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
+    bool process_set_accgyrosetup(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
           
 };
 
 
-bool embot::app::application::theCANparserMTB::Impl::process(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserMTB::Impl::process(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     txframe = false;
     recognised = false;
@@ -145,7 +145,7 @@ bool embot::app::application::theCANparserMTB::Impl::process(const embot::hw::ca
 
 
 
-bool embot::app::application::theCANparserMTB::Impl::process_set_brdcfg(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserMTB::Impl::process_set_brdcfg(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_aspoll_SKIN_SET_BRD_CFG msg;
     msg.load(frame);
@@ -157,7 +157,7 @@ bool embot::app::application::theCANparserMTB::Impl::process_set_brdcfg(const em
 }
 
 
-bool embot::app::application::theCANparserMTB::Impl::process_set_trgcfg(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserMTB::Impl::process_set_trgcfg(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_aspoll_SKIN_SET_TRIANG_CFG msg;
     msg.load(frame);
@@ -169,7 +169,7 @@ bool embot::app::application::theCANparserMTB::Impl::process_set_trgcfg(const em
 }
 
 
-bool embot::app::application::theCANparserMTB::Impl::process_set_accgyrosetup(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserMTB::Impl::process_set_accgyrosetup(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_aspoll_ACC_GYRO_SETUP msg;
     msg.load(frame);
@@ -181,7 +181,7 @@ bool embot::app::application::theCANparserMTB::Impl::process_set_accgyrosetup(co
 }
 
 
-bool embot::app::application::theCANparserMTB::Impl::process_set_txmode(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserMTB::Impl::process_set_txmode(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_aspoll_SET_TXMODE msg(embot::app::canprotocol::Board::mtb4);
     msg.load(frame);
@@ -227,12 +227,14 @@ bool embot::app::application::theCANparserMTB::initialise(Config &config)
     // retrieve address
     pImpl->canaddress = canbrdinfo.getCANaddress();
     
+    embot::app::canprotocol::addClassFilter(embot::app::canprotocol::Clas::pollingAnalogSensor, pImpl->canaddress);
+    
     return true;
 }
   
 
 
-bool embot::app::application::theCANparserMTB::process(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theCANparserMTB::process(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {    
     return pImpl->process(frame, replies);
 }
@@ -28,7 +28,7 @@
 #include "embot_sys.h"
 
 
-#include <vector>
+#include "embot_app_FrameSink.h"
 
 namespace embot { namespace app { namespace application {
            
@@ -53,7 +53,7 @@ namespace embot { namespace app { namespace application {
         bool initialise(Config &config); 
         
         // returns true if the canframe has been recognised. if so, any reply is sent if replies.size() > 0
-        bool process(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
+        bool process(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
 
     private:
         theCANparserMTB(); 
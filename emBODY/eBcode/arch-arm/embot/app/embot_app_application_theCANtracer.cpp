@@ -52,15 +52,58 @@ struct embot::app::application::theCANtracer::Impl
         
     embot::common::Time starttime;
     
+    // the ring of the binary trace. the producers are many (any task or isr) and they reserve a slot inside a short 
+    // critical section, the consumer is only one and it is the only one which moves tail.
+    static const std::uint32_t ringsize = 128; // must be a power of two
+    Record ring[ringsize];
+    volatile std::uint32_t head;
+    volatile std::uint32_t tail;
+    volatile std::uint32_t dropped;     // the total number of lost records 
+    std::uint32_t reported;             // the lost records already signalled with Event::overflow
     
     Impl() 
     {   
         starttime = 0;  
+        head = tail = 0;
+        dropped = reported = 0;
     }
     
+    void put(Event event, std::uint32_t arg)
+    {
+        const std::uint32_t info = static_cast<std::uint32_t>(event) | (arg << 8);
+        std::uint32_t state = embot::hw::sys::irqdisable();
+        const std::uint32_t h = head;
+        if((h - tail) >= ringsize)
+        {
+            dropped++;
+        }
+        else
+        {
+            ring[h & (ringsize-1)].stamp = embot::hw::sys::cyclecounter();
+            ring[h & (ringsize-1)].info = info;
+            head = h + 1;
+        }
+        embot::hw::sys::irqrestore(state);
+    }
+    
+    void transmit(const Record &record, embot::app::FrameSink &frames)
+    {
+        embot::app::canprotocol::Message_mcper_TRACE msg;
+        embot::app::canprotocol::Message_mcper_TRACE::Info info;
+        info.canaddress = config.canaddress;
+        info.stamp = record.stamp;
+        info.event = static_cast<std::uint8_t>(record.event());
+        info.arg = record.arg();
+        msg.load(info);
+        embot::hw::can::Frame frame;
+        msg.get(frame);
+        frames.push(frame);
+    }
                   
 };
 
+const std::uint32_t embot::app::application::theCANtracer::Impl::ringsize;
+
 
 
 
@@ -81,9 +124,87 @@ embot::app::application::theCANtracer::theCANtracer()
         
 bool embot::app::application::theCANtracer::initialise(Config &config)
 {
-    pImpl->config = config;    
+    pImpl->config = config; 
+
+    if(true == pImpl->config.tracing)
+    {
+        embot::hw::sys::startcyclecounter();
+        pImpl->put(Event::clock, embot::hw::sys::clock() / 1000);
+    }
+    
     return true;
 }
+
+
+void embot::app::application::theCANtracer::trace(Event event, std::uint32_t arg)
+{
+    if(false == pImpl->config.tracing)
+    {
+        return;
+    }
+    
+    pImpl->put(event, arg);
+}
+
+
+std::uint32_t embot::app::application::theCANtracer::pending() const
+{
+    const std::uint32_t overflow = (pImpl->dropped != pImpl->reported) ? 1 : 0;
+    return pImpl->head - pImpl->tail + overflow;
+}
+
+
+std::uint32_t embot::app::application::theCANtracer::lost() const
+{
+    return pImpl->dropped;
+}
+
+
+std::uint8_t embot::app::application::theCANtracer::flush(embot::app::FrameSink &frames, std::uint8_t maxframes)
+{
+    std::uint8_t n = 0;
+    
+    const std::uint32_t dropped = pImpl->dropped;
+    if((dropped != pImpl->reported) && (n < maxframes) && (false == frames.full()))
+    {   // the gap is signalled before the records which follow it and with the stamp of the first of them
+        Record r;
+        r.stamp = (pImpl->tail != pImpl->head) ? pImpl->ring[pImpl->tail & (Impl::ringsize-1)].stamp : embot::hw::sys::cyclecounter();
+        r.info = static_cast<std::uint32_t>(Event::overflow) | ((dropped - pImpl->reported) << 8);
+        pImpl->transmit(r, frames);
+        pImpl->reported = dropped;
+        n++;
+    }
+    
+    while((n < maxframes) && (false == frames.full()) && (pImpl->tail != pImpl->head))
+    {
+        const std::uint32_t t = pImpl->tail;
+        pImpl->transmit(pImpl->ring[t & (Impl::ringsize-1)], frames);
+        // only after the copy the producers can reuse the slot
+        pImpl->tail = t + 1;
+        n++;
+    }
+    
+    return n;
+}
+
+
+std::uint32_t embot::app::application::theCANtracer::snapshot(Record *records, std::uint32_t capacity) const
+{
+    if(nullptr == records)
+    {
+        return 0;
+    }
+    
+    const std::uint32_t t = pImpl->tail;
+    const std::uint32_t h = pImpl->head;
+    std::uint32_t n = 0;
+    for(std::uint32_t i=t; (i!=h) && (n<capacity); i++)
+    {
+        records[n++] = pImpl->ring[i & (Impl::ringsize-1)];
+    }
+    
+    return n;
+}
   
 
 
@@ -94,7 +215,19 @@ embot::common::Time embot::app::application::theCANtracer::start()
 }
 
 
-embot::common::relTime embot::app::application::theCANtracer::stop(const std::string &prefix, std::vector<embot::hw::can::Frame> &frames, embot::common::Time started)
+embot::common::relTime embot::app::application::theCANtracer::stop(const std::string &prefix, embot::app::FrameSink &frames, embot::common::Time started)
+{ 
+    return stop(prefix.c_str(), frames, started);
+}
+
+
+bool embot::app::application::theCANtracer::print(const std::string &text, embot::app::FrameSink &frames)
+{ 
+    return print(text.c_str(), frames);
+}
+
+
+embot::common::relTime embot::app::application::theCANtracer::stop(const char *prefix, embot::app::FrameSink &frames, embot::common::Time started)
 { 
     embot::common::Time tt = embot::sys::timeNow();
     
@@ -107,9 +240,8 @@ embot::common::relTime embot::app::application::theCANtracer::stop(const std::st
     tt -= started;    
     embot::common::relTime delta = static_cast<embot::common::relTime>(tt);
     
-    char strTT[12] = {0};
-    std::snprintf(strTT, sizeof(strTT), "%d", delta);    
-    std::string text = prefix + std::string(strTT);
+    char text[32] = {0};
+    std::snprintf(text, sizeof(text), "%s%d", (nullptr == prefix) ? "" : prefix, delta);    
     
     theCANtracer::print(text, frames);
 
@@ -117,13 +249,13 @@ embot::common::relTime embot::app::application::theCANtracer::stop(const std::st
 }
 
 
-bool embot::app::application::theCANtracer::print(const std::string &text, std::vector<embot::hw::can::Frame> &frames)
+bool embot::app::application::theCANtracer::print(const char *text, embot::app::FrameSink &frames)
 { 
     embot::app::canprotocol::Message_mcper_PRINT msg;
     embot::app::canprotocol::Message_mcper_PRINT::Info info;
 
     info.canaddress = pImpl->config.canaddress;
-    std::snprintf(info.text, sizeof(info.text), "%s", text.c_str());
+    std::snprintf(info.text, sizeof(info.text), "%s", (nullptr == text) ? "" : text);
        
     msg.load(info);
     std::uint8_t nframes = msg.numberofframes();
@@ -132,7 +264,7 @@ bool embot::app::application::theCANtracer::print(const std::string &text, std::
     {    
         embot::hw::can::Frame frame0;
         msg.get(frame0);
-        frames.push_back(frame0);
+        frames.push(frame0);
     }
     
     return true;    
@@ -30,7 +30,7 @@
 #include "embot_app_canprotocol.h"
 
 
-#include <vector>
+#include "embot_app_FrameSink.h"
 #include <string>
 
 namespace embot { namespace app { namespace application {
@@ -49,16 +49,51 @@ namespace embot { namespace app { namespace application {
         struct Config
         {
             std::uint8_t        canaddress;
-            Config() : canaddress(1) {}
+            bool                tracing;        // it enables the binary trace
+            Config() : canaddress(1), tracing(false) {}
         }; 
         
+        // the ids of the events of the binary trace. they are compile-time constants so that trace() formats nothing.
+        // clock and overflow are generated internally: the arg of clock is the cpu clock in khz and it allows the host
+        // to convert the stamps into time, the arg of overflow is the number of records lost because the ring was full.
+        enum class Event : std::uint8_t { none = 0, clock = 1, overflow = 2, 
+                                          skinacquirebegin = 16, skinacquireend = 17, skintransmit = 18,
+                                          imutick = 32, 
+                                          user = 128 };
+        
+        // what the ring stores for each event: the cycle counter of the cpu and the event with a 24-bit argument. 
+        struct Record
+        {
+            std::uint32_t       stamp;
+            std::uint32_t       info;           // event in the 8 lsbs, arg in the 24 msbs
+            Event event() const { return static_cast<Event>(info & 0xff); }
+            std::uint32_t arg() const { return info >> 8; }
+        };
+        
         
         bool initialise(Config &config);   
+        
+        // the binary trace. trace() costs a few tens of cycles, can be called by any task or isr and does nothing
+        // if Config::tracing is false. when the ring is full the new records are lost and counted.
+        void trace(Event event, std::uint32_t arg = 0);
+        // the number of records waiting to be flushed (plus one if some were lost)
+        std::uint32_t pending() const;
+        // it moves up to maxframes records into frames, one can frame each (Message_mcper_TRACE). it must be called 
+        // always by the same task, possibly when there is nothing better to do.
+        std::uint8_t flush(embot::app::FrameSink &frames, std::uint8_t maxframes);
+        // it copies up to capacity of the pending records, the oldest first, without removing them: it is for a 
+        // debugger or a backdoor.
+        std::uint32_t snapshot(Record *records, std::uint32_t capacity) const;
+        // the records lost because the ring was full
+        std::uint32_t lost() const;
 
         
         embot::common::Time start();
-        embot::common::relTime stop(const std::string &prefix, std::vector<embot::hw::can::Frame> &frames, embot::common::Time started = 0);    
-        bool print(const std::string &text, std::vector<embot::hw::can::Frame> &frames);        
+        embot::common::relTime stop(const std::string &prefix, embot::app::FrameSink &frames, embot::common::Time started = 0);    
+        bool print(const std::string &text, embot::app::FrameSink &frames);  
+        // as above but they do not use any heap
+        embot::common::relTime stop(const char *prefix, embot::app::FrameSink &frames, embot::common::Time started = 0);    
+        bool print(const char *text, embot::app::FrameSink &frames);        
 
     private:
         theCANtracer(); 
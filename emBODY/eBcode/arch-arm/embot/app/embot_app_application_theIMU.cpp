@@ -113,7 +113,7 @@ struct embot::app::application::theIMU::Impl
     bool start();
     bool stop();
     
-    bool tick(std::vector<embot::hw::can::Frame> &replies);
+    bool tick(embot::app::FrameSink &replies);
     
     bool configure(embot::app::canprotocol::Message_aspoll_ACC_GYRO_SETUP::Info &ag);
     
@@ -189,7 +189,7 @@ bool embot::app::application::theIMU::Impl::acquisition()
 }
 
 
-bool embot::app::application::theIMU::Impl::tick(std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theIMU::Impl::tick(embot::app::FrameSink &replies)
 {   
     if(false == ticking)
     {
@@ -202,6 +202,7 @@ bool embot::app::application::theIMU::Impl::tick(std::vector<embot::hw::can::Fra
     }
     
     // perform acquisition
+    embot::app::application::theCANtracer::getInstance().trace(theCANtracer::Event::imutick, accgyroinfo.maskoftypes);
     acquisition();
     
     embot::hw::can::Frame frame;   
@@ -214,7 +215,7 @@ bool embot::app::application::theIMU::Impl::tick(std::vector<embot::hw::can::Fra
         {
             msg.load(accelinfo);
             msg.get(frame);
-            replies.push_back(frame);
+            replies.push(frame);
         }            
     }
     
@@ -226,7 +227,7 @@ bool embot::app::application::theIMU::Impl::tick(std::vector<embot::hw::can::Fra
         {
             msg.load(gyrosinfo);
             msg.get(frame);
-            replies.push_back(frame);
+            replies.push(frame);
         }            
     }    
        
@@ -307,7 +308,7 @@ bool embot::app::application::theIMU::stop()
 }
 
 
-bool embot::app::application::theIMU::tick(std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theIMU::tick(embot::app::FrameSink &replies)
 {   
     return pImpl->tick(replies);
 }
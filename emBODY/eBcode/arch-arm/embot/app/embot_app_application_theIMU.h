@@ -30,7 +30,7 @@
 #include "embot_app_canprotocol.h"
 
 
-#include <vector>
+#include "embot_app_FrameSink.h"
 
 namespace embot { namespace app { namespace application {
            
@@ -59,7 +59,7 @@ namespace embot { namespace app { namespace application {
         
         bool start();
         bool stop();        
-        bool tick(std::vector<embot::hw::can::Frame> &replies);
+        bool tick(embot::app::FrameSink &replies);
 
     private:
         theIMU(); 
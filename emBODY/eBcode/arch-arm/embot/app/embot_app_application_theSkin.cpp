@@ -53,8 +53,6 @@
 // - pimpl: private implementation (see scott meyers: item 22 of effective modern c++, item 31 of effective c++
 // --------------------------------------------------------------------------------------------------------------------
 
-//#define TEST_CANPRINT
-
 static const std::uint8_t dotNumberOf = 12;
 static const std::uint8_t trgNumberOf = 16;
 
@@ -79,6 +77,20 @@ struct TriangleErr
     TriangleErr() : mask(0) {}
 };
 
+// what was last transmitted for each triangle. it is used in delta mode (boardconfig.deadband > 0) to
+// suppress the triangles whose values have not changed by more than the deadband.
+struct TriangleHistory
+{
+    static const std::uint8_t   defaultKEYFRAME = 10;   // in ticks. used if deadband is not zero but keyframe is.
+    std::uint16_t       validmask;                      // bit t is set if lastsent[t] holds what was transmitted
+    std::uint8_t        countdown;                      // when it reaches zero all active triangles are transmitted
+    std::uint8_t        lastsent[trgNumberOf][dotNumberOf];
+    std::uint64_t       lastmasks[trgNumberOf];         // the masks of outofrange, notack, notconnected packed together
+    void reset() { validmask = 0; countdown = 0; }
+    void invalidate(std::uint8_t trg) { embot::common::bit::clear(validmask, trg); std::memset(lastsent[trg], 0, dotNumberOf); lastmasks[trg] = 0; }
+    TriangleHistory() : validmask(0), countdown(0) { std::memset(lastsent, 0, sizeof(lastsent)); std::memset(lastmasks, 0, sizeof(lastmasks)); }
+};
+
 struct Triangles
 {
     std::uint16_t       activemask;
@@ -122,6 +134,10 @@ struct embot::app::application::theSkin::Impl
     embot::app::canprotocol::Message_aspoll_SKIN_SET_TRIANG_CFG::Info triangleconfigcommand;
     
     Triangles triangles;
+    
+    TriangleHistory history;
+    
+    Statistics statistics;
 
     std::uint8_t canaddress;
 
@@ -146,7 +162,7 @@ struct embot::app::application::theSkin::Impl
     bool start();
     bool stop();
     
-    bool tick(std::vector<embot::hw::can::Frame> &replies);
+    bool tick(embot::app::FrameSink &replies);
     
     bool configtriangles(embot::app::canprotocol::Message_aspoll_SKIN_SET_TRIANG_CFG::Info &trgcfg);
     
@@ -154,7 +170,9 @@ struct embot::app::application::theSkin::Impl
     
     bool fill(embot::app::canprotocol::Message_skper_TRG::Info &info, const std::uint8_t trg);
     
-    int computedrift(std::uint8_t trg, std::uint8_t dot);
+    bool changed(const embot::app::canprotocol::Message_skper_TRG::Info &info, const std::uint8_t trg);
+    
+    void computedrift(std::uint8_t trg, const if2hw_data_ad7147_t *the12rawvalues, const if2hw_data_ad7147_t *the12capoffsets, int *drift);
                   
 };
 
@@ -180,6 +198,9 @@ bool embot::app::application::theSkin::Impl::configtriangles(embot::app::canprot
             embot::common::bit::clear(triangles.activemask, i);
         }
         
+        // a triangle whose enable or config changes must not be compared with what it transmitted before
+        history.invalidate(i);
+        
         // we process shift and cdcoffset even if we have enabled == false ... as the old mtb3 application does
         
         triangles.config[i].shift = triangleconfigcommand.shift;
@@ -215,10 +236,8 @@ bool embot::app::application::theSkin::Impl::calibrate()
 
 bool embot::app::application::theSkin::Impl::start()
 {
-#if defined(TEST_CANPRINT)  
-    embot::app::application::theCANtracer &tr = embot::app::application::theCANtracer::getInstance();      
-    tr.start();
-#endif
+    // the first tick after a start always transmits everything
+    history.reset();
     
     ticktimer->start(boardconfig.txperiod, embot::sys::Timer::Type::forever, action);
     ticking = true;    
@@ -233,57 +252,77 @@ bool embot::app::application::theSkin::Impl::stop()
     return true;
 }
 
-int embot::app::application::theSkin::Impl::computedrift(std::uint8_t trg, std::uint8_t dot)
+void embot::app::application::theSkin::Impl::computedrift(std::uint8_t trg, const if2hw_data_ad7147_t *the12rawvalues, const if2hw_data_ad7147_t *the12capoffsets, int *drift)
 {
-    std::uint8_t gain = 0; 
-    if2hw_data_ad7147_t Tpad_base = 0;
-    if2hw_data_ad7147_t Tpad = 0;
-    
-    int drift = 0;
+    const std::uint8_t *gains = nullptr; 
+    std::uint8_t tpad = 0;
     
     switch(boardconfig.skintype)
     {        
         case embot::app::canprotocol::Message_aspoll_SKIN_SET_BRD_CFG::SkinType::withTemperatureCompensation:
         {
-            gain = triangles.GAIN[dot];  
-            Tpad_base = triangles.capoffsets[trg][6]; // in original mtb3 code there is ADCRESULT_S6 which is defined as 6
-            Tpad = triangles.rawvalues[trg][6];
-                
-            if(Tpad > Tpad_base)
-            {
-                drift = ( ( (Tpad - Tpad_base) >> 2) * gain ) >> 5;
-            }
-            else
-            {
-                drift = -( ( (Tpad_base - Tpad) >> 2) * gain ) >> 5;
-            }     
+            gains = triangles.GAIN;  
+            tpad = 6;   // in original mtb3 code there is ADCRESULT_S6 which is defined as 6
         } break;
         
         case embot::app::canprotocol::Message_aspoll_SKIN_SET_BRD_CFG::SkinType::palmFingerTip:
         {
-            gain = triangles.GAIN_PALM[dot];  // in original mtb3 code GAIN_PALM[] is ... all zero, hence drift is ZERO! 
-            Tpad_base = triangles.capoffsets[trg][11]; // in original mtb3 code there is ADCRESULT_S11 which is defined as 11
-            Tpad = triangles.rawvalues[trg][11];
-                
-            if(Tpad > Tpad_base)
-            {
-                drift = ( ( (Tpad - Tpad_base) >> 2) * gain ) >> 5;
-            }
-            else
-            {
-                drift = -( ( (Tpad_base - Tpad) >> 2) * gain ) >> 5;
-            }     
+            gains = triangles.GAIN_PALM;  // in original mtb3 code GAIN_PALM[] is ... all zero, hence drift is ZERO! 
+            tpad = 11;  // in original mtb3 code there is ADCRESULT_S11 which is defined as 11
         } break;
         
         default:
         case embot::app::canprotocol::Message_aspoll_SKIN_SET_BRD_CFG::SkinType::testmodeRAW:
         case embot::app::canprotocol::Message_aspoll_SKIN_SET_BRD_CFG::SkinType::withoutTempCompensation:
         {
-            drift = 0;
+            gains = nullptr;
         } break;                
     }
+    
+    if(nullptr == gains)
+    {
+        std::memset(drift, 0, dotNumberOf*sizeof(int));
+        return;
+    }
+    
+    // the temperature pad is the same for all the dots of the triangle, hence we evaluate it only once.
+    // the formula is the one of the original mtb3 code: the dot only changes the gain.
+    const int Tpad_base = static_cast<int>(the12capoffsets[tpad]);
+    const int Tpad = static_cast<int>(the12rawvalues[tpad]);
+    
+    if(Tpad > Tpad_base)
+    {
+        const int delta = (Tpad - Tpad_base) >> 2;
+        for(std::uint8_t i=0; i<dotNumberOf; i++)
+        {
+            drift[i] = (delta * gains[i]) >> 5;
+        }
+    }
+    else
+    {
+        const int delta = (Tpad_base - Tpad) >> 2;
+        for(std::uint8_t i=0; i<dotNumberOf; i++)
+        {
+            drift[i] = -(delta * gains[i]) >> 5;
+        }
+    }
+}
+
 
-    return drift;    
+// it is equivalent to the original mtb3 code: 
+// if(value <= -UP_LIMIT) v = max; else if(value >= BOT_LIMIT) v = min; else v = noload - (value >> shift);
+// because UP_LIMIT = (max-noload) << shift, BOT_LIMIT = noload << shift and [min, max] = [0, 255].
+// on the cortex-m4 it is a single USAT instruction.
+static_assert((0 == ad7147_dot_value_min) && (255 == ad7147_dot_value_max), "theSkin: s_compensate() requires taxel values in [0, 255]");
+
+static inline std::uint8_t s_compensate(int value, std::uint8_t shift, int noload)
+{
+    int v = noload - (value >> shift);
+#if defined(__CC_ARM)
+    return static_cast<std::uint8_t>(__usat(v, 8));
+#else
+    return static_cast<std::uint8_t>((v < 0) ? 0 : ((v > 255) ? 255 : v));
+#endif    
 }
 
 
@@ -316,49 +355,40 @@ bool embot::app::application::theSkin::Impl::fill(embot::app::canprotocol::Messa
     }
 
     // all other cases require a compensation
-
-    int UP_LIMIT = static_cast<int>(ad7147_dot_value_max-boardconfig.noload) << triangles.config[trg].shift;
-    int BOT_LIMIT = static_cast<int>(boardconfig.noload) << triangles.config[trg].shift;
+    
+    const std::uint8_t shift = triangles.config[trg].shift;
+    const int noload = static_cast<int>(boardconfig.noload);
+    // the check vs a strange value (original comment: if the sensor is far from the limits -> taxel could be broken)
+    // uses twice the limits of the valid range
+    const int UP_LIMITx2 = (static_cast<int>(ad7147_dot_value_max-boardconfig.noload) << shift) << 1;
+    const int BOT_LIMITx2 = (static_cast<int>(boardconfig.noload) << shift) << 1;
+    
+    int drift[dotNumberOf];
+    computedrift(trg, the12rawvalues, the12capoffsets, drift);
        
-    int value = 0; 
-    int drift = 0;
+    std::uint16_t outofrange = 0;
+    std::uint16_t notconnected = 0;
+    std::uint16_t notack = 0;
  
     for(std::uint8_t i=0; i<dotNumberOf; i++)
     {
-        drift = computedrift(trg, i);
-        value = static_cast<int>(the12rawvalues[i]) - static_cast<int>(the12capoffsets[i]) - drift;
+        const int raw = static_cast<int>(the12rawvalues[i]);
+        const int cap = static_cast<int>(the12capoffsets[i]);
+        const int value = raw - cap - drift[i];
             
-        if(value <= -UP_LIMIT)
-        {
-            info.the12s[i] = ad7147_dot_value_max;  // out of range, pressure too low
-        }
-        else if(value >= BOT_LIMIT)
-        {
-            info.the12s[i] = ad7147_dot_value_min;  // out of range, pressure too high
-        }
-        else // if((value > -UP_LIMIT) && (value < BOT_LIMIT))
-        {
-            info.the12s[i] = boardconfig.noload - (value >> triangles.config[trg].shift);
-        }
+        info.the12s[i] = s_compensate(value, shift, noload);
         
-        // check vs a strange value (original comment: if the sensor is far from the limits -> taxel could be broken)
-        if((value <= -(UP_LIMIT<<1)) || (value >= (BOT_LIMIT << 1)))
-        {
-            embot::common::bit::set(info.outofrangemaskofthe12s, i);  
-        }                    
-    
-        // check if any errors on rawvalues[i]              
-        if(0xffff == the12rawvalues[i])
-        {
-            embot::common::bit::set(info.notconnectedmaskofthe12s, i);                    
-        }
-        else if((0 == the12rawvalues[i]) && (0 != the12capoffsets[i]))
-        {
-            embot::common::bit::set(info.notackmaskofthe12s, i);                    
-        }
+        outofrange |= static_cast<std::uint16_t>((value <= -UP_LIMITx2) || (value >= BOT_LIMITx2)) << i;
+        // check if any errors on rawvalues[i]  
+        notconnected |= static_cast<std::uint16_t>(0xffff == raw) << i;
+        notack |= static_cast<std::uint16_t>((0xffff != raw) && (0 == raw) && (0 != cap)) << i;
     }
     
+    info.outofrangemaskofthe12s = outofrange;
+    info.notconnectedmaskofthe12s = notconnected;
+    info.notackmaskofthe12s = notack;
     
+
 //    bool triangleISnotconnected = false;
 //    if(dotNumberOf == embot::common::bit::count(info.notconnectedmaskofthe12s))
 //    {
@@ -394,24 +424,52 @@ bool embot::app::application::theSkin::Impl::fill(embot::app::canprotocol::Messa
 }
 
 
-bool embot::app::application::theSkin::Impl::tick(std::vector<embot::hw::can::Frame> &replies)
+static inline std::uint64_t s_masksof(const embot::app::canprotocol::Message_skper_TRG::Info &info)
+{
+    return static_cast<std::uint64_t>(info.outofrangemaskofthe12s) | (static_cast<std::uint64_t>(info.notackmaskofthe12s) << 16) | 
+           (static_cast<std::uint64_t>(info.notconnectedmaskofthe12s) << 32);
+}
+
+// in delta mode it tells if the triangle must be transmitted: that happens if it was never transmitted, if any of its
+// masks is different or if any of its values differs from the last transmitted one by more than the deadband. 
+bool embot::app::application::theSkin::Impl::changed(const embot::app::canprotocol::Message_skper_TRG::Info &info, const std::uint8_t trg)
+{
+    const std::uint64_t masks = s_masksof(info);
+    
+    if((false == embot::common::bit::check(history.validmask, trg)) || (masks != history.lastmasks[trg]))
+    {
+        return true;
+    }
+    
+    const int deadband = boardconfig.deadband;
+    const std::uint8_t *last = history.lastsent[trg];
+    int maxdiff = 0;
+    for(std::uint8_t i=0; i<dotNumberOf; i++)
+    {
+        int d = static_cast<int>(info.the12s[i]) - static_cast<int>(last[i]);
+        d = (d < 0) ? -d : d;
+        maxdiff = (d > maxdiff) ? d : maxdiff;
+    }
+    
+    return (maxdiff > deadband);
+}
+
+
+bool embot::app::application::theSkin::Impl::tick(embot::app::FrameSink &replies)
 {   
     if(false == ticking)
     {
         return false;
     }
     
-#if defined(TEST_CANPRINT)     
-    embot::app::application::theCANtracer &tr = embot::app::application::theCANtracer::getInstance();
-    tr.stop(std::string("u"), replies);    
-    tr.start();
-//    tr.print(std::string("ciao uomo, come stai? io bene!xxx devo dire. anche se il protocollo tronca oltre xxx"), replies);
-#endif  
-    
+    // the duration of the acquisition goes into the binary trace, which does not format any string nor 
+    // uses the can bus here.
     embot::app::application::theCANtracer &tr = embot::app::application::theCANtracer::getInstance(); 
-    tr.start();
-    ad7147_acquire();  
-    tr.stop(std::string("u"), replies);       
+    tr.trace(theCANtracer::Event::skinacquirebegin, triangles.activemask);
+    // we read over i2c only the groups of triangles which contain at least one active triangle: 
+    // the values of the inactive ones are never used.
+    ad7147_acquire_triangles(triangles.activemask);  
+    tr.trace(theCANtracer::Event::skinacquireend);
 
 #if 1
     
@@ -424,27 +482,65 @@ bool embot::app::application::theSkin::Impl::tick(std::vector<embot::hw::can::Fr
     
     // acquire and transmit ...
     
+    // in delta mode we transmit only the triangles which have changed, apart every keyframe ticks when we transmit them all.
+    // deadband = 0 keeps the legacy behaviour: everything is transmitted at every tick.
+    const bool deltamode = (0 != boardconfig.deadband);
+    bool keyframe = true;
+    if(true == deltamode)
+    {
+        keyframe = (0 == history.countdown);
+        if(true == keyframe)
+        {
+            history.countdown = (0 != boardconfig.keyframe) ? boardconfig.keyframe : TriangleHistory::defaultKEYFRAME;
+        }
+        history.countdown--;
+    }
+    
     embot::app::canprotocol::Message_skper_TRG msg;
     embot::app::canprotocol::Message_skper_TRG::Info info;
     for(std::uint8_t t=0; t<trgNumberOf; t++)
     {
         if(true == embot::common::bit::check(triangles.activemask, t))
-        {                
-            if(true == fill(info, t))
+        {
+            // the cost of the compensation is measured with the cycle counter of the dwt. 
+            // the unsigned difference is correct also across a wrap of the counter.
+            const std::uint32_t c0 = embot::hw::sys::cyclecounter();
+            const bool filled = fill(info, t);
+            statistics.fillcycleslast = embot::hw::sys::cyclecounter() - c0;
+            if(statistics.fillcycleslast > statistics.fillcyclesmax)
             {
+                statistics.fillcyclesmax = statistics.fillcycleslast;
+            }
+            
+            if(true == filled)
+            {
+                if(true == deltamode)
+                {
+                    if((false == keyframe) && (false == changed(info, t)))
+                    {
+                        statistics.suppressedframes += 2;
+                        continue;
+                    }
+                    std::memcpy(history.lastsent[t], info.the12s, dotNumberOf);
+                    history.lastmasks[t] = s_masksof(info);
+                    embot::common::bit::set(history.validmask, t);
+                }
+                
+                statistics.transmittedframes += 2;
                 msg.load(info);
                 
                 embot::hw::can::Frame frame0;
                 embot::hw::can::Frame frame1;
                 msg.get(frame0, frame1);
-                replies.push_back(frame0);
-                replies.push_back(frame1);
+                replies.push(frame0);
+                replies.push(frame1);
             }
         }
     }
 
 #endif
 
+    tr.trace(theCANtracer::Event::skintransmit, replies.size());
     
     return true;    
 }
@@ -474,7 +570,11 @@ bool embot::app::application::theSkin::initialise(Config &config)
     embot::app::theCANboardInfo &canbrdinfo = embot::app::theCANboardInfo::getInstance();
     pImpl->canaddress = canbrdinfo.getCANaddress();
     
+    // used to measure the cycles per triangle of fill(). see getstatistics()
+    embot::hw::sys::startcyclecounter();
+    
     pImpl->triangles.activemask = 0xffff;
+    pImpl->history.reset();
     
     ad7147_init(pImpl->triangles.rawvalues, pImpl->triangles.capoffsets);
     
@@ -498,6 +598,8 @@ bool embot::app::application::theSkin::configure(embot::app::canprotocol::Messag
     
     // ? should i?
     pImpl->triangles.activemask = 0;
+    // the enable mask has changed: nothing of what was transmitted before is valid anymore
+    pImpl->history.reset();
             
     if(true == pImpl->ticking)
     {
@@ -527,11 +629,17 @@ bool embot::app::application::theSkin::stop()
     return pImpl->stop();
 }
 
-bool embot::app::application::theSkin::tick(std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::application::theSkin::tick(embot::app::FrameSink &replies)
 {   
     return pImpl->tick(replies);
 }
 
+bool embot::app::application::theSkin::getstatistics(Statistics &stats)
+{   
+    stats = pImpl->statistics;
+    return true;
+}
+
 // - end-of-file (leave a blank line after)----------------------------------------------------------------------------
 
 
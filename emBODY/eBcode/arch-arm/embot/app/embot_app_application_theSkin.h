@@ -30,7 +30,7 @@
 #include "embot_app_canprotocol.h"
 
 
-#include <vector>
+#include "embot_app_FrameSink.h"
 
 namespace embot { namespace app { namespace application {
            
@@ -58,9 +58,19 @@ namespace embot { namespace app { namespace application {
         bool configure(embot::app::canprotocol::Message_aspoll_SKIN_SET_BRD_CFG::Info &brdcfg);
         bool configure(embot::app::canprotocol::Message_aspoll_SKIN_SET_TRIANG_CFG::Info &trgcfg);
         
+        struct Statistics
+        {
+            std::uint32_t   transmittedframes;
+            std::uint32_t   suppressedframes;   // frames not sent in delta mode because their triangle had not changed
+            std::uint32_t   fillcycleslast;     // cpu cycles spent in the compensation of the last triangle
+            std::uint32_t   fillcyclesmax;      // and the maximum ever seen
+            Statistics() : transmittedframes(0), suppressedframes(0), fillcycleslast(0), fillcyclesmax(0) {}
+        };
+        
         bool start();
         bool stop();        
-        bool tick(std::vector<embot::hw::can::Frame> &replies);
+        bool tick(embot::app::FrameSink &replies);
+        bool getstatistics(Statistics &stats);
 
     private:
         theSkin(); 
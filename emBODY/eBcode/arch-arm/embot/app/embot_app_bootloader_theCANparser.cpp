@@ -162,30 +162,32 @@ struct embot::app::bootloader::theCANparser::Impl
         {
             canbrdinfo.setCANaddress(target);
             canaddress = canbrdinfo.getCANaddress();
+            embot::app::canprotocol::changeClassFilterAddress(canaddress);
         }
         
         return (target == canaddress);
     }
     
     
-    bool process(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
+    bool process(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
     
-    bool process_bl_broadcast(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);    
-    bool process_bl_board(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
-    bool process_bl_address(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
-    bool process_bl_data(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
-    bool process_bl_start(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
-    bool process_bl_end(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
-    bool process_bl_getadditionalinfo(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
-    bool process_bl_setadditionalinfo(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
+    bool process_bl_broadcast(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);    
+    bool process_bl_board(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
+    bool process_bl_address(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
+    bool process_bl_data(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
+    bool process_bl_start(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
+    bool process_bl_end(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
+    bool process_bl_getadditionalinfo(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
+    bool process_bl_setadditionalinfo(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
+    bool process_bl_getpagecrc(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
     
-    bool process_setid(const embot::app::canprotocol::Clas cl, const std::uint8_t cm, const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
-    bool process_bl_setcanaddress(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies);
+    bool process_setid(const embot::app::canprotocol::Clas cl, const std::uint8_t cm, const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
+    bool process_bl_setcanaddress(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies);
         
 };
 
 
-bool embot::app::bootloader::theCANparser::Impl::process(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::bootloader::theCANparser::Impl::process(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     txframe = false;
     
@@ -289,7 +291,7 @@ bool embot::app::bootloader::theCANparser::Impl::process(const embot::hw::can::F
         case Impl::State::Updating:
         {
             // we are in firmware-updating mode. any non specific command will be ignored.
-            // only: bldrCMD::ADDRESS, bldrCMD::DATA, bldrCMD::START, bldrCMD::END
+            // only: bldrCMD::ADDRESS, bldrCMD::DATA, bldrCMD::START, bldrCMD::END, bldrCMD::GET_PAGE_CRC
             // the correct flux would be: { ADDRESS, { DATA }_as_specified_in_address_frame }_as_many_as_lines_in_the_hex_file, START, END.
             // BUT: the canLoader will take care of having a correct flux. only check is: the reply of DATA when it receives the correct number of 
             // bytes. if any wrong one (or lost) the bootloader will fail the fw-udpate but will not be corrupted itself. 
@@ -309,6 +311,11 @@ bool embot::app::bootloader::theCANparser::Impl::process(const embot::hw::can::F
                         txframe = process_bl_data(frame, replies);
                     } break;
                     
+                    case static_cast<std::uint8_t>(embot::app::canprotocol::bldrCMD::GET_PAGE_CRC):
+                    {   // before the hex rows: the host asks the crc of the pages in flash and it sends only the rows of the pages which differ
+                        txframe = process_bl_getpagecrc(frame, replies);
+                    } break;
+                    
                     case static_cast<std::uint8_t>(embot::app::canprotocol::bldrCMD::START):
                     {   // only one of such messages: it tells that the hew rows are over. time to flush rx data into flash
                         txframe = process_bl_start(frame, replies);
@@ -344,7 +351,7 @@ bool embot::app::bootloader::theCANparser::Impl::process(const embot::hw::can::F
 
 
 
-bool embot::app::bootloader::theCANparser::Impl::process_bl_broadcast(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::bootloader::theCANparser::Impl::process_bl_broadcast(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_bldr_BROADCAST msg;
     msg.load(frame);
@@ -362,7 +369,7 @@ bool embot::app::bootloader::theCANparser::Impl::process_bl_broadcast(const embo
         
     if(true == msg.reply(reply, canaddress, replyinfo))
     {
-        replies.push_back(reply);
+        replies.push(reply);
         return true;
     }        
     
@@ -370,7 +377,7 @@ bool embot::app::bootloader::theCANparser::Impl::process_bl_broadcast(const embo
 }
 
 
-bool embot::app::bootloader::theCANparser::Impl::process_bl_board(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::bootloader::theCANparser::Impl::process_bl_board(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_bldr_BOARD msg;
     msg.load(frame);
@@ -382,14 +389,14 @@ bool embot::app::bootloader::theCANparser::Impl::process_bl_board(const embot::h
             
     if(true == msg.reply(reply, canaddress))
     {
-        replies.push_back(reply);
+        replies.push(reply);
         return true;
     }        
     
     return false;       
 }
 
-bool embot::app::bootloader::theCANparser::Impl::process_bl_address(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::bootloader::theCANparser::Impl::process_bl_address(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_bldr_ADDRESS msg;
     msg.load(frame);
@@ -403,7 +410,7 @@ bool embot::app::bootloader::theCANparser::Impl::process_bl_address(const embot:
 }
 
 
-bool embot::app::bootloader::theCANparser::Impl::process_bl_data(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::bootloader::theCANparser::Impl::process_bl_data(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_bldr_DATA msg;
     msg.load(frame);
@@ -413,7 +420,7 @@ bool embot::app::bootloader::theCANparser::Impl::process_bl_data(const embot::hw
     {   // ok, i can pass data to the flashburner
         
         // the flashburner object takes care of accepting data, to buffer it in efficient modes, and to write it to flash.
-        // the first time it needs to write a page of flash, it also erases all the flash pages used by the application.
+        // it erases a page of flash only when it writes it, so only the pages used by the new application are erased.
         flashburner->add(curr_blrdAddressInfo.address+curr_blrdAddress_datalenreceivedsofar, msg.info.size, msg.info.data);
         
         // now i increment data received so far.
@@ -424,7 +431,7 @@ bool embot::app::bootloader::theCANparser::Impl::process_bl_data(const embot::hw
             
             if(true == msg.reply(reply, canaddress, true))
             {
-                replies.push_back(reply);
+                replies.push(reply);
                 return true;
             }            
             return false;                
@@ -438,7 +445,7 @@ bool embot::app::bootloader::theCANparser::Impl::process_bl_data(const embot::hw
 }
 
 
-bool embot::app::bootloader::theCANparser::Impl::process_bl_start(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::bootloader::theCANparser::Impl::process_bl_start(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {        
     embot::app::canprotocol::Message_bldr_START msg;
     msg.load(frame);
@@ -446,6 +453,18 @@ bool embot::app::bootloader::theCANparser::Impl::process_bl_start(const embot::h
     // it flushes ...   
     flashburner->flush();
     
+    bool ok = true;
+    
+    if(true == msg.info.checkimage)
+    {   // the host may have sent only the pages which changed: the whole image in flash must be the one it has. 
+        // if not, we erase its first page so that the bootloader does not jump to it.
+        ok = (0 != msg.info.size) && (msg.info.crc32 == flashburner->crc32(embot::hw::sys::addressOfApplication, msg.info.size));
+        if(false == ok)
+        {
+            flashburner->invalidate();
+        }
+    }
+    
     // it erases userdefineddata 
     if(true == eraseAPPLstorage)
     {
@@ -454,29 +473,29 @@ bool embot::app::bootloader::theCANparser::Impl::process_bl_start(const embot::h
         canbrdinfo.userdataerase();
     }
         
-    if(true == msg.reply(reply, canaddress, true))
+    if(true == msg.reply(reply, canaddress, ok))
     {
-        replies.push_back(reply);
+        replies.push(reply);
         return true;
     } 
     return false;    
 }
 
 
-bool embot::app::bootloader::theCANparser::Impl::process_bl_end(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::bootloader::theCANparser::Impl::process_bl_end(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_bldr_END msg;
     msg.load(frame);
         
     if(true == msg.reply(reply, canaddress, true))
     {
-        replies.push_back(reply);
+        replies.push(reply);
         return true;
     } 
     return false;     
 }
 
-bool embot::app::bootloader::theCANparser::Impl::process_bl_getadditionalinfo(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::bootloader::theCANparser::Impl::process_bl_getadditionalinfo(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_bldr_GET_ADDITIONAL_INFO msg;
     msg.load(frame);
@@ -493,7 +512,7 @@ bool embot::app::bootloader::theCANparser::Impl::process_bl_getadditionalinfo(co
     {
         if(true == msg.reply(reply, canaddress, replyinfo))
         {
-            replies.push_back(reply);
+            replies.push(reply);
         }
     }
     return true;
@@ -501,7 +520,29 @@ bool embot::app::bootloader::theCANparser::Impl::process_bl_getadditionalinfo(co
 }
 
 
-bool embot::app::bootloader::theCANparser::Impl::process_bl_setadditionalinfo(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::bootloader::theCANparser::Impl::process_bl_getpagecrc(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
+{
+    embot::app::canprotocol::Message_bldr_GET_PAGE_CRC msg;
+    if(false == msg.load(frame))
+    {
+        return false;
+    }
+    
+    // the pages are counted from the start of the application. a page out of the application has crc 0xffffffff.
+    embot::app::canprotocol::Message_bldr_GET_PAGE_CRC::ReplyInfo replyinfo;
+    replyinfo.page = msg.info.page;
+    replyinfo.crc32 = flashburner->crc32(embot::hw::sys::addressOfApplication + msg.info.page*flashburner->pagesize(), flashburner->pagesize());
+    
+    if(true == msg.reply(reply, canaddress, replyinfo))
+    {
+        replies.push(reply);
+        return true;
+    } 
+    return false;      
+}
+
+
+bool embot::app::bootloader::theCANparser::Impl::process_bl_setadditionalinfo(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_bldr_SET_ADDITIONAL_INFO2 msg;
     msg.load(frame);
@@ -518,7 +559,7 @@ bool embot::app::bootloader::theCANparser::Impl::process_bl_setadditionalinfo(co
 }
 
 
-bool embot::app::bootloader::theCANparser::Impl::process_setid(const embot::app::canprotocol::Clas cl, const std::uint8_t cm, const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::bootloader::theCANparser::Impl::process_setid(const embot::app::canprotocol::Clas cl, const std::uint8_t cm, const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_base_SET_ID msg(cl, cm);
     msg.load(frame);
@@ -528,7 +569,7 @@ bool embot::app::bootloader::theCANparser::Impl::process_setid(const embot::app:
     return msg.reply();        
 }
 
-bool embot::app::bootloader::theCANparser::Impl::process_bl_setcanaddress(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::bootloader::theCANparser::Impl::process_bl_setcanaddress(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {
     embot::app::canprotocol::Message_bldr_SETCANADDRESS msg;
     msg.load(frame);
@@ -573,6 +614,11 @@ bool embot::app::bootloader::theCANparser::initialise(Config &config)
         pImpl->version.build = 0;
         pImpl->board = static_cast<embot::app::canprotocol::Board>(storedinfo.boardtype);        
     }
+    
+    // we let the hw discard what we would reject anyway in process()
+    embot::app::canprotocol::addClassFilter(embot::app::canprotocol::Clas::bootloader, pImpl->canaddress);
+    embot::app::canprotocol::addClassFilter(embot::app::canprotocol::Clas::pollingMotorControl, pImpl->canaddress);
+    embot::app::canprotocol::addClassFilter(embot::app::canprotocol::Clas::pollingAnalogSensor, pImpl->canaddress);
       
     
     return true;
@@ -580,7 +626,7 @@ bool embot::app::bootloader::theCANparser::initialise(Config &config)
   
 
 
-bool embot::app::bootloader::theCANparser::process(const embot::hw::can::Frame &frame, std::vector<embot::hw::can::Frame> &replies)
+bool embot::app::bootloader::theCANparser::process(const embot::hw::can::Frame &frame, embot::app::FrameSink &replies)
 {    
     return pImpl->process(frame, replies);
 }
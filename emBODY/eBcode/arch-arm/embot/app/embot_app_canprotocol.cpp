@@ -63,6 +63,10 @@ namespace embot { namespace app { namespace canprotocol {
         {
             return bldrCMD::SET_ADDITIONAL_INFO;
         }        
+        else if(cmd == static_cast<std::uint8_t>(bldrCMD::GET_PAGE_CRC))
+        {
+            return bldrCMD::GET_PAGE_CRC;
+        }  
         else if(cmd == static_cast<std::uint8_t>(bldrCMD::SETCANADDRESS))
         {
             return bldrCMD::SETCANADDRESS;
@@ -316,6 +320,59 @@ namespace embot { namespace app { namespace canprotocol {
         return ret;
     }
     
+    static std::uint8_t s_filteredclasses = 0;     // bit i is set if Clas i has been added with addClassFilter()
+    
+    static bool s_addclassfilter(Clas cls, std::uint8_t boardaddress)
+    {
+        std::uint32_t clsid = static_cast<std::uint32_t>(cls) << 8;
+        
+        embot::hw::can::Frame frame;
+        frame.id = clsid;
+        if(true == frameisperiodic(frame))
+        {   // destination is not in the id: we accept the whole class
+            return (embot::hw::resOK == embot::hw::can::addFilter(embot::hw::can::Port::one, clsid, 0x700));
+        }
+        
+        // destination is in bits [3:0]: we want our address and the broadcast
+        bool ok = (embot::hw::resOK == embot::hw::can::addFilter(embot::hw::can::Port::one, clsid | 0xf, 0x70f));
+        if((0xf & boardaddress) != 0xf)
+        {
+            ok = ok && (embot::hw::resOK == embot::hw::can::addFilter(embot::hw::can::Port::one, clsid | (0xf & boardaddress), 0x70f));
+        }
+        return ok;
+    }
+    
+    bool addClassFilter(Clas cls, std::uint8_t boardaddress)
+    {
+        if(static_cast<std::uint8_t>(cls) > 7)
+        {
+            return false;
+        }
+        
+        embot::common::bit::set(s_filteredclasses, static_cast<std::uint8_t>(cls));
+        return s_addclassfilter(cls, boardaddress);
+    }
+    
+    bool changeClassFilterAddress(std::uint8_t boardaddress)
+    {
+        if(0 == s_filteredclasses)
+        {   // nobody has ever asked for filters: keep receiving everything
+            return true;
+        }
+        
+        embot::hw::can::clearFilters(embot::hw::can::Port::one);
+        
+        bool ok = true;
+        for(std::uint8_t c=0; c<8; c++)
+        {
+            if(true == embot::common::bit::check(s_filteredclasses, c))
+            {
+                ok = s_addclassfilter(static_cast<Clas>(c), boardaddress) && ok;
+            }
+        }
+        return ok;
+    }
+    
     bool frame_set_sender(embot::hw::can::Frame &frame, std::uint8_t sender, bool verify)
     {
         frame.id &= ~0x000000F0;
@@ -479,6 +536,17 @@ namespace embot { namespace app { namespace canprotocol {
             {
                 return false; 
             }
+            
+            info.checkimage = false;
+            info.crc32 = 0;
+            info.size = 0;
+            
+            if(candata.sizeofdatainframe >= 7)
+            {
+                info.checkimage = true;
+                info.crc32 = candata.datainframe[0] | (static_cast<std::uint32_t>(candata.datainframe[1]) << 8) | (static_cast<std::uint32_t>(candata.datainframe[2]) << 16) | (static_cast<std::uint32_t>(candata.datainframe[3]) << 24);
+                info.size = candata.datainframe[4] | (static_cast<std::uint32_t>(candata.datainframe[5]) << 8) | (static_cast<std::uint32_t>(candata.datainframe[6]) << 16);
+            }
           
             return true;         
         }                    
@@ -649,6 +717,41 @@ namespace embot { namespace app { namespace canprotocol {
         }   
         
 
+        bool Message_bldr_GET_PAGE_CRC::load(const embot::hw::can::Frame &inframe)
+        {
+            Message::set(inframe);  
+            
+            if(static_cast<std::uint8_t>(bldrCMD::GET_PAGE_CRC) != frame2cmd(inframe))
+            {
+                return false; 
+            }
+            
+            if(candata.sizeofdatainframe < 2)
+            {
+                return false;
+            }
+            
+            info.page = candata.datainframe[0] | (static_cast<std::uint16_t>(candata.datainframe[1]) << 8);
+          
+            return true;         
+        }  
+        
+        bool Message_bldr_GET_PAGE_CRC::reply(embot::hw::can::Frame &outframe, const std::uint8_t sender, const ReplyInfo &replyinfo)
+        {
+            frame_set_sender(outframe, sender);
+            char dd[6] = {0};
+            dd[0] = replyinfo.page & 0xff;
+            dd[1] = (replyinfo.page >> 8) & 0xff;
+            dd[2] = replyinfo.crc32 & 0xff;
+            dd[3] = (replyinfo.crc32 >> 8) & 0xff;
+            dd[4] = (replyinfo.crc32 >> 16) & 0xff;
+            dd[5] = (replyinfo.crc32 >> 24) & 0xff;
+            frame_set_clascmddestinationdata(outframe, Clas::bootloader, static_cast<std::uint8_t>(bldrCMD::GET_PAGE_CRC), candata.from, dd, 6);
+            frame_set_size(outframe, 7);
+            return true;
+        }  
+        
+
         bool Message_bldr_SET_ADDITIONAL_INFO::load(const embot::hw::can::Frame &inframe)
         {
             Message::set(inframe);  
@@ -854,6 +957,8 @@ namespace embot { namespace app { namespace canprotocol {
             
             info.txperiod = 1000*candata.datainframe[1]; // transform from msec into usec
             info.noload = candata.datainframe[2];
+            info.deadband = (candata.sizeofdatainframe > 3) ? candata.datainframe[3] : 0;
+            info.keyframe = (candata.sizeofdatainframe > 4) ? candata.datainframe[4] : 0;
           
             return true;         
         } 
@@ -987,6 +1092,31 @@ namespace embot { namespace app { namespace canprotocol {
         }  
 
 
+        bool Message_mcper_TRACE::load(const Info& inf)
+        {
+            info = inf;
+          
+            return true;
+        }
+            
+        bool Message_mcper_TRACE::get(embot::hw::can::Frame &outframe)
+        {
+            std::uint8_t data08[8] = {0};
+            data08[0] = static_cast<std::uint8_t>(info.stamp & 0xff);
+            data08[1] = static_cast<std::uint8_t>((info.stamp >> 8) & 0xff);
+            data08[2] = static_cast<std::uint8_t>((info.stamp >> 16) & 0xff);
+            data08[3] = static_cast<std::uint8_t>((info.stamp >> 24) & 0xff);
+            data08[4] = info.event;
+            data08[5] = static_cast<std::uint8_t>(info.arg & 0xff);
+            data08[6] = static_cast<std::uint8_t>((info.arg >> 8) & 0xff);
+            data08[7] = static_cast<std::uint8_t>((info.arg >> 16) & 0xff);
+            Message::set(info.canaddress, 0xf, Clas::periodicMotorControl, static_cast<std::uint8_t>(mcperCMD::TRACE), data08, 8);
+            std::memmove(&outframe, &canframe, sizeof(embot::hw::can::Frame));
+                        
+            return true;
+        }  
+
+
         bool Message_aspoll_ACC_GYRO_SETUP::load(const embot::hw::can::Frame &inframe)
         {
             Message::set(inframe);  
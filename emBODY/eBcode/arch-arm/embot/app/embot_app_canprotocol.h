@@ -33,7 +33,7 @@ namespace embot { namespace app { namespace canprotocol {
     
     enum class Clas { pollingMotorControl = 0, periodicMotorControl = 1, pollingAnalogSensor = 2, periodicAnalogSensor = 3, periodicSkin = 4, periodicInertialSensor = 5, bootloader = 7, none = 255 };
 
-    enum class bldrCMD { none = 0xfe, BROADCAST = 0xff, BOARD = 0x00, ADDRESS = 0x01, START = 0x02, DATA = 0x03, END = 0x04, GET_ADDITIONAL_INFO = 12, SET_ADDITIONAL_INFO = 13, SETCANADDRESS = 0x32 };
+    enum class bldrCMD { none = 0xfe, BROADCAST = 0xff, BOARD = 0x00, ADDRESS = 0x01, START = 0x02, DATA = 0x03, END = 0x04, GET_ADDITIONAL_INFO = 12, SET_ADDITIONAL_INFO = 13, GET_PAGE_CRC = 14, SETCANADDRESS = 0x32 };
     
     enum class anypollCMD { none = 0xfe, SETID = 0x32 };
     
@@ -41,7 +41,9 @@ namespace embot { namespace app { namespace canprotocol {
     
     enum class aspollCMD { none = 0xfe, SET_TXMODE = 0x07, GET_FIRMWARE_VERSION = 0x1C, SET_BOARD_ADX = 0x32, SKIN_SET_BRD_CFG = 77, ACC_GYRO_SETUP = 79, SKIN_SET_TRIANG_CFG = 80 };
     
-    enum class mcperCMD { PRINT = 6 };
+    // TRACE uses 14, which is not assigned in the periodic motor control class of the icub can protocol: 
+    // the ems has no parser for it and the 2foc boards do not receive it (15 is EMSTO2FOC_DESIRED_CURRENT).
+    enum class mcperCMD { PRINT = 6, TRACE = 14 };
     
     enum class skperCMD { TRG00 = 0, TRG01 = 1, TRG02 = 2, TRG03 = 3, TRG04 = 4, TRG05 = 5, TRG06 = 6, TRG07 = 7, TRG08 = 8, TRG09 = 9, 
                           TRG10 = 10, TRG11 = 11, TRG12 = 12, TRG13 = 13, TRG14 = 14, TRG15 = 15 };
@@ -123,6 +125,14 @@ namespace embot { namespace app { namespace canprotocol {
     
     bool frame_set_size(embot::hw::can::Frame &frame, std::uint8_t size, bool verify = false);
     
+    // it adds to embot::hw::can the acceptance filters which let the board receive the frames of class cls: 
+    // all of them if cls is periodic, else only those whose destination is boardaddress or broadcast (0xf).
+    // the class is remembered, so that changeClassFilterAddress() can reprogram the filters when the board changes address.
+    bool addClassFilter(Clas cls, std::uint8_t boardaddress);
+    
+    // it clears every filter of embot::hw::can and adds again the ones of the classes added by addClassFilter() 
+    bool changeClassFilterAddress(std::uint8_t boardaddress);
+    
 
     
     // this class is used for receiving but also for transmitting.
@@ -265,10 +275,14 @@ namespace embot { namespace app { namespace canprotocol {
     {
         public:
             
+        // the legacy START has no data. if it carries 7 bytes, they are the crc32 (4 bytes) and the size (3 bytes) of the
+        // whole application image as the host has it. the image is checked after the flush and START is acked only if it matches.
         struct Info
         { 
-            std::uint8_t    thereisnothing;  
-            Info() : thereisnothing(0) {}
+            bool            checkimage;
+            std::uint32_t   crc32;
+            std::uint32_t   size;
+            Info() : checkimage(false), crc32(0), size(0) {}
         };
         
         Info info;
@@ -421,6 +435,37 @@ namespace embot { namespace app { namespace canprotocol {
     };  
 
     
+    // it asks the crc32 of a page of the application which is now in flash. the page is counted from the start of the
+    // application. the host compares it with the crc32 of the same page of the new image and it sends only the pages which differ.
+    // the crc is the one of embot::hw::FlashBurner::crc32(): a page past the end of the application area gives 0xffffffff and
+    // the last page covers only the bytes inside the area.
+    class Message_bldr_GET_PAGE_CRC : public Message
+    {
+        public:
+            
+        struct Info
+        { 
+            std::uint16_t   page;  
+            Info() : page(0) {}
+        };
+        
+        Info info;
+        
+        struct ReplyInfo
+        {
+            std::uint16_t   page;
+            std::uint32_t   crc32;
+            ReplyInfo() : page(0), crc32(0) {}
+        };
+        
+        Message_bldr_GET_PAGE_CRC() {}
+            
+        bool load(const embot::hw::can::Frame &inframe);
+            
+        bool reply(embot::hw::can::Frame &outframe, const std::uint8_t sender, const ReplyInfo &replyinfo);   // page + crc32     
+    };
+    
+    
     class Message_bldr_SETCANADDRESS : public Message
     {
         public:
@@ -579,8 +624,11 @@ namespace embot { namespace app { namespace canprotocol {
         { 
             SkinType                    skintype;  
             std::uint8_t                noload; 
-            embot::common::relTime      txperiod;              
-            Info() : skintype(SkinType::none), noload(0), txperiod(50*embot::common::time1millisec) {}
+            embot::common::relTime      txperiod;    
+            // optional bytes (they are zero if the host does not send them, hence the legacy behaviour is kept):
+            std::uint8_t                deadband;       // if not zero a triangle is transmitted only if any of its values has changed by more than deadband  
+            std::uint8_t                keyframe;       // if deadband is not zero, all the active triangles are transmitted anyway every keyframe ticks.           
+            Info() : skintype(SkinType::none), noload(0), txperiod(50*embot::common::time1millisec), deadband(0), keyframe(0) {}
         };
         
         Info info;
@@ -673,6 +721,30 @@ namespace embot { namespace app { namespace canprotocol {
         std::uint8_t nchars;           
         static std::uint8_t textIDmod4;  // 0, 1, 2, 3, 0, 1, 2, etc      
     }; 
+    
+    class Message_mcper_TRACE : public Message
+    {
+        public:
+            
+        // a binary trace record in one frame of 8 bytes: [stamp (4 bytes, little endian)] [event] [arg (3 bytes, little endian)].
+        // it is decoded on the host by embot::tools::TraceDecoder.
+        struct Info
+        { 
+            std::uint32_t               stamp;      // in cpu cycles
+            std::uint8_t                event;
+            std::uint32_t               arg;        // only the 24 lsbs are transmitted
+            std::uint8_t                canaddress;
+            Info() : stamp(0), event(0), arg(0), canaddress(0) {}
+        };
+        
+        Info info;
+        
+        Message_mcper_TRACE() {}
+            
+        bool load(const Info& inf);
+            
+        bool get(embot::hw::can::Frame &outframe);        
+    };
 
     class Message_aspoll_ACC_GYRO_SETUP : public Message
     {
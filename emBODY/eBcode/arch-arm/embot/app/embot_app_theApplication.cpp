@@ -99,6 +99,10 @@ void embot::app::theApplication::execute(Config &config)
     cfg.onfatalerror = embot::app::theApplication::Impl::onfatal;
     cfg.clockfrequency = embot::hw::sys::clock();
     cfg.ticktime = config.osaltickperiod;
+    if(true == config.tickless)
+    {
+        cfg.setTickless(embot::hw::sys::sleep);
+    }
     
     thescheduler.init(cfg);
     thescheduler.start();    
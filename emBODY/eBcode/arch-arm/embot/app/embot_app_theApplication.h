@@ -67,16 +67,19 @@ namespace embot { namespace app {
             StackSizes                          stacksizes;
             UserDefOperations                   operations;
             std::uint32_t                       addressofapplication;
+            bool                                tickless;   // if true the idle task stops the osal tick when nothing is due
             Config() :
                         osaltickperiod(embot::common::time1millisec),
                         // for structs we rely on their default ctor
-                        addressofapplication(embot::hw::sys::addressOfApplication)
+                        addressofapplication(embot::hw::sys::addressOfApplication),
+                        tickless(false)
                         {}
-            Config(embot::common::relTime _osaltickperiod, const StackSizes &_stacksizes, const UserDefOperations &_operations, std::uint32_t address = embot::hw::sys::addressOfApplication) :
+            Config(embot::common::relTime _osaltickperiod, const StackSizes &_stacksizes, const UserDefOperations &_operations, std::uint32_t address = embot::hw::sys::addressOfApplication, bool _tickless = false) :
                         osaltickperiod(_osaltickperiod), 
                         stacksizes(_stacksizes), 
                         operations(_operations),
-                        addressofapplication(address)            
+                        addressofapplication(address),
+                        tickless(_tickless)
                         {}
         }; 
                       
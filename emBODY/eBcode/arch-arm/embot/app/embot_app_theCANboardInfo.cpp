@@ -127,6 +127,11 @@ bool embot::app::theCANboardInfo::synch(embot::app::canprotocol::versionOfAPPLIC
     StoredInfo strd = {0};
     ret = get(strd);
     
+    if((validityKey == strd.key) && (((strd.bootloaderVmajor << 8) | strd.bootloaderVminor) >= ((logawareBootloaderVmajor << 8) | logawareBootloaderVminor)))
+    {   // the bootloader also reads the log, so we can use it
+        pImpl->flashstorage->setlayout(embot::hw::FlashStorage::Layout::log);
+    }
+    
     if(validityKey != strd.key)
     {
         std::memset(&strd, 0, sizeof(strd));
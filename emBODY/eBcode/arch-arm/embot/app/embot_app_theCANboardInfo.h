@@ -43,6 +43,11 @@ namespace embot { namespace app {
     public:
     
         static const std::uint32_t validityKey = 0x8888dead;
+        // the storage is shared by bootloader and application. older bootloaders know only embot::hw::FlashStorage::Layout::rawpage,
+        // so the application moves it to Layout::log only if the stored version of the bootloader is at least this one.
+        // once moved, the board must not get back a bootloader or an application which are older than that.
+        static const std::uint8_t logawareBootloaderVmajor = 1;
+        static const std::uint8_t logawareBootloaderVminor = 1;
         struct StoredInfo
         {   // contains the basics stored inside some embot::i2h::Storage
             std::uint32_t       key;
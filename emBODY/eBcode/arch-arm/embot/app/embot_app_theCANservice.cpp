@@ -95,6 +95,25 @@ bool embot::app::can::SkinProtocol::parse(const embot::hw::can::Frame &frame)
     return true;
 }
 
+bool embot::app::can::SkinProtocol::parse(const embot::hw::can::Frame *frames, std::uint8_t number)
+{
+    hw::can::Frame canframes[theCANservice::burstsize];
+    
+    while(number > 0)
+    {
+        std::uint8_t n = (number > theCANservice::burstsize) ? theCANservice::burstsize : number;
+        for(std::uint8_t i=0; i<n; i++)
+        {
+            canframes[i] = frames[i];
+            canframes[i].data[0]++;
+        }
+        hw::can::put(hw::can::Port::one, canframes, n);
+        frames += n;
+        number -= n;
+    }
+    return true;
+}
+
 bool embot::app::can::SkinProtocol::parse(const embot::hw::can::Frame &frame, embot::app::can::Message &message, const embot::app::can::Address &address)
 {
     
@@ -150,6 +169,21 @@ bool embot::app::can::SkinProtocol::form(const embot::app::can::Message &message
 }}}
 
 
+bool embot::app::can::Protocol::parse(const embot::hw::can::Frame *frames, std::uint8_t number)
+{
+    bool ret = true;
+    for(std::uint8_t i=0; i<number; i++)
+    {
+        if(false == parse(frames[i]))
+        {
+            ret = false;
+        }
+    }
+    return ret;
+}
+
+
+const std::uint8_t embot::app::can::theCANservice::burstsize;
 
 
 struct embot::app::can::theCANservice::Impl
@@ -158,6 +192,8 @@ struct embot::app::can::theCANservice::Impl
     
     embot::app::can::theCANservice::Config config;
     
+    embot::hw::can::Frame burst[burstsize];
+    
     Impl() 
     {              
         dd = 0;   
@@ -246,14 +282,16 @@ std::uint8_t embot::app::can::theCANservice::sizeOfTXqueue()
 
 bool embot::app::can::theCANservice::parse_core(uint8_t numofframes, uint8_t &remaining)
 {
-    for(uint8_t i=0; i<numofframes; i++)
+    // we drain the rx queue in bursts and pass each burst to the protocol with a single virtual call
+    while(numofframes > 0)
     {
-        hw::can::Frame canframe;
-        hw::result_t res = hw::can::get(hw::can::Port::one, canframe, remaining);
-        if(hw::resNOK == res)
+        uint8_t n = (numofframes > burstsize) ? burstsize : numofframes;
+        n = hw::can::get(hw::can::Port::one, pImpl->burst, n, remaining);
+        if(0 == n)
             return false;
     
-        pImpl->config.protocol->parse(canframe);
+        pImpl->config.protocol->parse(pImpl->burst, n);
+        numofframes -= n;
     }
     return true;
 }
@@ -274,7 +312,7 @@ bool embot::app::can::theCANservice::parse(std::uint8_t maxnumber, std::uint8_t
     else
         frame2read = maxnumber;
     
-    return (parse_core(size, remaining));
+    return (parse_core(frame2read, remaining));
 }
 
 
@@ -291,6 +329,34 @@ bool embot::app::can::theCANservice::add(embot::app::can::Message &msg, embot::a
         return true;
 }        
 
+bool embot::app::can::theCANservice::addBatch(embot::app::can::Message *msgs, std::uint8_t number, embot::app::can::Address &toaddress)
+{  
+    if(nullptr == msgs)
+    {
+        return false;
+    }
+    
+    bool ret = true;
+    
+    while(number > 0)
+    {
+        std::uint8_t n = (number > burstsize) ? burstsize : number;
+        for(std::uint8_t i=0; i<n; i++)
+        {
+            pImpl->config.protocol->form(msgs[i], toaddress, pImpl->burst[i]); 
+        }
+        
+        if(n != hw::can::put(hw::can::Port::one, pImpl->burst, n))
+        {
+            ret = false;
+        }
+        msgs += n;
+        number -= n;
+    }
+    
+    return ret;
+}  
+
 bool embot::app::can::theCANservice::transmit(embot::common::relTime timeout, std::uint8_t &transmitted)
 {   
     #warning VALE: the check of timeout in theCANservice::transmit is not implemented!!!
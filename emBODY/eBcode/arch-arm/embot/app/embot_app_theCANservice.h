@@ -62,6 +62,9 @@ namespace embot { namespace app { namespace can {
              
         // it calls the action associated to ...
         virtual bool parse(const embot::hw::can::Frame &frame) = 0;
+        // it calls the action associated to a burst of frames. the default calls parse(frame) for each of them, 
+        // but a derived class can do better by processing them all together.
+        virtual bool parse(const embot::hw::can::Frame *frames, std::uint8_t number);
         // it only returns the message and the sender. the caller will manage the action associated.
         virtual bool parse(const embot::hw::can::Frame &frame, embot::app::can::Message &message, const embot::app::can::Address &address) = 0;
         // the caller takes the frame and adds it to the ...
@@ -78,6 +81,7 @@ namespace embot { namespace app { namespace can {
         bool init();
         
         virtual bool parse(const embot::hw::can::Frame &frame);
+        virtual bool parse(const embot::hw::can::Frame *frames, std::uint8_t number);
         virtual bool parse(const embot::hw::can::Frame &frame, embot::app::can::Message &message, const embot::app::can::Address &address);
         virtual bool form(const embot::app::can::Message &message, const embot::app::can::Address &address, embot::hw::can::Frame &frame);    
 
@@ -103,6 +107,8 @@ namespace embot { namespace app { namespace can {
                 
     public:
     
+        static const std::uint8_t burstsize = 16;  // max number of frames retrieved from the rx queue and passed to Protocol in a single call
+    
         struct Config
         {
             embot::common::relTime      canstabilizationtime;
@@ -124,6 +130,9 @@ namespace embot { namespace app { namespace can {
         
         bool add(embot::app::can::Message &msg, embot::app::can::Address &toaddress);
         
+        // it forms all the number messages and puts them in the tx queue at once. it returns true only if all are queued.
+        bool addBatch(embot::app::can::Message *msgs, std::uint8_t number, embot::app::can::Address &toaddress);
+        
         bool transmit(embot::common::relTime timeout, std::uint8_t &transmitted);
                 
     private:
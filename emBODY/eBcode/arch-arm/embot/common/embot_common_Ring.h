@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * Author:  agent
+ * email:   agent@local
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+// - include guard ----------------------------------------------------------------------------------------------------
+
+#ifndef _EMBOT_COMMON_RING_H_
+#define _EMBOT_COMMON_RING_H_
+
+#include "embot_common.h"
+
+
+namespace embot { namespace common {
+
+    // what a Ring does when put() finds it full.
+    // - dropOldest: the new item is stored and the oldest one is lost (as the old std::vector based can queues did).
+    // - dropNewest: the new item is refused.
+    // in both cases the lost item is counted in overflows().
+    enum class OverflowPolicy : std::uint8_t { dropOldest = 0, dropNewest = 1 };
+
+
+    // a fixed size FIFO for one producer and one consumer which can live in different execution contexts
+    // (e.g., an ISR and a task) without any critical section. put() and get() are O(1) and never allocate.
+    // - storage is static and has N slots, N must be a power of two.
+    // - the capacity is decided at runtime with init() and must be a value in [1, N].
+    // - head is written only by the producer, tail only by the consumer.
+    //   with OverflowPolicy::dropOldest the producer does not touch tail: it simply goes on writing and the
+    //   consumer, if it sees that it was overrun, jumps ahead and discards what it had just read.
+    //   that works only if the producer may preempt the consumer and not vice versa (e.g., ISR producer and task
+    //   consumer). if the consumer is the ISR, either use dropNewest or mask the ISR around put().
+
+    template<typename T, std::uint32_t N>
+    class Ring
+    {
+    public:
+
+        static_assert((N > 0) && (0 == (N & (N-1))), "embot::common::Ring<T, N>: N must be a power of two");
+
+        Ring() : cap(N), policy(OverflowPolicy::dropOldest), head(0), tail(0), overflowed(0) {}
+
+        // it returns false and it leaves the ring untouched if capacity is not in [1, N].
+        bool init(std::uint32_t capacity, OverflowPolicy overflowpolicy = OverflowPolicy::dropOldest)
+        {
+            if((0 == capacity) || (capacity > N))
+            {
+                return false;
+            }
+            cap = capacity;
+            policy = overflowpolicy;
+            head = tail = 0;
+            overflowed = 0;
+            return true;
+        }
+
+        std::uint32_t capacity() const { return cap; }
+
+        // it can be called by both producer and consumer.
+        std::uint32_t size() const
+        {
+            std::uint32_t s = head - tail;
+            return (s > cap) ? cap : s;
+        }
+
+        bool empty() const { return (head == tail); }
+
+        bool full() const { return (size() >= cap); }
+
+        std::uint32_t overflows() const { return overflowed; }
+
+        // to be called only by the producer.
+        bool put(const T &item)
+        {
+            std::uint32_t h = head;
+            if((h - tail) >= cap)
+            {
+                overflowed++;
+                if(OverflowPolicy::dropNewest == policy)
+                {
+                    return false;
+                }
+            }
+            slots[h & (N-1)] = item;
+            barrier();
+            head = h + 1;
+            return true;
+        }
+
+        // to be called only by the consumer. it returns false if the ring is empty.
+        bool get(T &item)
+        {
+            for(;;)
+            {
+                std::uint32_t t = tail;
+                std::uint32_t h = head;
+                if(h == t)
+                {
+                    return false;
+                }
+                if((h - t) > cap)
+                {   // the producer has overrun us. the oldest items are lost: skip them
+                    t = h - cap;
+                }
+                item = slots[t & (N-1)];
+                barrier();
+                if((head - t) <= cap)
+                {   // the slot was not overwritten while we were copying it
+                    tail = t + 1;
+                    return true;
+                }
+                // else the producer has overwritten the slot in the meantime: it is surely in an ISR which has
+                // preempted us and which has now returned. we just retry with the new head.
+                tail = t;
+            }
+        }
+
+        // to be called only by the consumer. it gets at most maxitems and returns how many were retrieved
+        std::uint32_t get(T *items, std::uint32_t maxitems)
+        {
+            std::uint32_t n = 0;
+            while((n < maxitems) && (true == get(items[n])))
+            {
+                n++;
+            }
+            return n;
+        }
+
+        // to be called only by the consumer.
+        void clear()
+        {
+            tail = head;
+        }
+
+    private:
+
+        static void barrier()
+        {   // a compiler barrier is enough because the producer and the consumer run on the same core.
+        #if defined(__CC_ARM)
+            __schedule_barrier();
+        #elif defined(__GNUC__)
+            __asm__ __volatile__("" ::: "memory");
+        #endif
+        }
+
+        std::uint32_t               cap;
+        OverflowPolicy              policy;
+        volatile std::uint32_t      head;
+        volatile std::uint32_t      tail;
+        volatile std::uint32_t      overflowed;
+        T                           slots[N];
+    };
+
+
+} } // namespace embot { namespace common {
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
+
@@ -75,10 +75,32 @@ namespace embot { namespace hw { namespace bsp {
         return resOK;
     }
     
+    static volatile std::uint32_t flashECCDevents = 0;
+    
+    std::uint32_t flashECCDcounter()
+    {
+        return flashECCDevents;
+    }
+    
 
 }}} // namespace embot { namespace hw { namespace bsp {
 
 
+// - stm32hal.lib does not have the NMI_Handler(), so it is compiled in here. 
+//   it clears the double ECC errors of flash, which raise the nmi, so that the execution continues.
+
+extern "C" { void NMI_Handler(void); }
+
+void NMI_Handler(void)
+{
+    if(__HAL_FLASH_GET_FLAG(FLASH_FLAG_ECCD))
+    {
+        __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ECCD);
+        embot::hw::bsp::flashECCDevents++;
+    }
+}
+
+
 
 
 namespace embot { namespace hw { namespace led {
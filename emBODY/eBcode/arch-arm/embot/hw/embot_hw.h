@@ -23,6 +23,7 @@
 #define _EMBOT_HW_H_
 
 #include "embot_common.h"
+#include "embot_common_Ring.h"
 
 
 namespace embot { namespace hw {
@@ -56,6 +57,11 @@ namespace embot { namespace hw { namespace bsp {
     bool initialised();
     
     result_t init(const Config &config);
+    
+    // a read of flash which gives a double ECC error (e.g., of a double word whose programming was cut by a power loss)
+    // raises the nmi, whose handler clears the error and increments this counter. whoever reads flash and must survive 
+    // such errors compares the counter before and after the reads: if it has changed, what was read is not valid.
+    std::uint32_t flashECCDcounter();
         
       
 }}} // namespace embot { namespace hw { namespace bsp {
@@ -129,6 +135,21 @@ namespace embot { namespace hw { namespace sys {
     
     void delay(embot::common::Time t);
     
+    // it is for the tickless mode of embot::sys::theScheduler: to be called only with the scheduler suspended.
+    // it reprograms the systick to expire after an integer number of ticks (at most maxtime), waits for an interrupt
+    // and returns the time slept, which is a multiple of tickperiod. 
+    embot::common::relTime sleep(embot::common::relTime maxtime, embot::common::relTime tickperiod);
+    
+    // the free running counter of cpu cycles of the cortex-m (dwt). it must be started once before use.
+    // it wraps every 2^32 / clock() seconds.
+    void startcyclecounter();
+    std::uint32_t cyclecounter();
+    
+    // a very short critical section vs every isr: irqdisable() returns the previous state to be given to irqrestore(),
+    // so that they can be nested.
+    std::uint32_t irqdisable();
+    void irqrestore(std::uint32_t state);
+    
     std::uint32_t random();
     std::uint32_t minrandom();
     std::uint32_t maxrandom();
@@ -168,14 +189,19 @@ namespace embot { namespace hw { namespace can {
     
     enum class Port { one = 0, two = 1, none = 32, maxnumberof = 2};
     
+    const std::uint8_t maxcapacity = 64;    // the tx and rx queues are statically allocated with this number of frames
+    
     struct Config
     {
-        std::uint8_t                txcapacity;
-        std::uint8_t                rxcapacity;
-        embot::common::Callback     ontxframe; 
-        embot::common::Callback     txqueueempty; 
-        embot::common::Callback     onrxframe;
-        Config() : txcapacity(8), rxcapacity(8), ontxframe(nullptr, nullptr), txqueueempty(nullptr, nullptr), onrxframe(nullptr, nullptr) {}
+        std::uint8_t                    txcapacity;     // in [1, maxcapacity], else init() fails
+        std::uint8_t                    rxcapacity;     // in [1, maxcapacity], else init() fails
+        embot::common::OverflowPolicy   txoverflow;
+        embot::common::OverflowPolicy   rxoverflow;
+        embot::common::Callback         ontxframe; 
+        embot::common::Callback         txqueueempty; 
+        embot::common::Callback         onrxframe;
+        Config() : txcapacity(8), rxcapacity(8), txoverflow(embot::common::OverflowPolicy::dropOldest), rxoverflow(embot::common::OverflowPolicy::dropOldest), 
+                   ontxframe(nullptr, nullptr), txqueueempty(nullptr, nullptr), onrxframe(nullptr, nullptr) {}
     };
     
     bool supported(Port p);
@@ -190,6 +216,9 @@ namespace embot { namespace hw { namespace can {
     
     result_t put(Port p, const Frame &frame);
     
+    // it puts up to number frames and returns how many were accepted
+    std::uint8_t put(Port p, const Frame *frames, std::uint8_t number);
+    
     std::uint8_t outputqueuesize(Port p);
     
     result_t transmit(Port p);
@@ -198,6 +227,37 @@ namespace embot { namespace hw { namespace can {
     
     result_t get(Port p, Frame &frame, std::uint8_t &remaining);
     
+    // it drains up to maxnumber frames into frames[] and returns how many were retrieved
+    std::uint8_t get(Port p, Frame *frames, std::uint8_t maxnumber, std::uint8_t &remaining);
+    
+    // number of frames lost by the queues because of overflow since init()
+    std::uint32_t outputqueueoverflows(Port p);
+    
+    std::uint32_t inputqueueoverflows(Port p);
+    
+    // acceptance filters on the standard 11 bit id: a frame is received only if it matches at least one of them.
+    // with no filter at all every frame is received (the default).
+    // they can be added also before init(). if they fit the hw filter banks they are programmed in there, 
+    // else the hw accepts every frame and the rx isr discards the ones which are not accepted().
+    struct Filter
+    {
+        std::uint32_t   id;
+        std::uint32_t   mask;
+        Filter() : id(0), mask(0) {}
+        Filter(std::uint32_t i, std::uint32_t m) : id(i & 0x7FF), mask(m & 0x7FF) {}
+        bool match(const Frame &frame) const { return ((frame.id & mask) == (id & mask)); }
+    };
+    
+    const std::uint8_t maxfilters = 28;
+    
+    result_t addFilter(Port p, std::uint32_t id, std::uint32_t mask);
+    
+    result_t clearFilters(Port p);
+    
+    std::uint8_t numberofFilters(Port p);
+    
+    bool accepted(Port p, const Frame &frame);
+    
     
     
 }}} // namespace embot { namespace hw { namespace can {
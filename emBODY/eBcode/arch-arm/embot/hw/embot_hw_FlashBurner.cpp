@@ -62,7 +62,13 @@ struct embot::hw::FlashBurner::Impl
     
     Buffer buffer;
     
-    bool isallerased;
+    // the pages are erased one at a time, just before they are programmed, so that only the pages which receive data
+    // are erased and the cost of the erase is spread along the transfer instead of being paid all at the first add().
+    // burnt[] keeps one bit per page of [start, start+size) which was already programmed in this session: if data
+    // comes again for such a page, its content is reloaded from flash so that it is not lost by the new erase.
+    uint32_t firstpage;
+    uint32_t numofpages;
+    uint32_t *burnt;
 
     
     // maybe move it to namespace hw ...
@@ -79,7 +85,7 @@ struct embot::hw::FlashBurner::Impl
     
     static uint32_t page2address(std::uint32_t page)
     {
-        return PAGEsize*page;
+        return embot::hw::sys::startOfFLASH + PAGEsize*page;
     }
     
     static uint32_t address2offset(std::uint32_t address)
@@ -87,41 +93,76 @@ struct embot::hw::FlashBurner::Impl
         return address % PAGEsize;
     }
     
-    bool eraseall()
+    bool isburnt(std::uint32_t page) const
     {
-        if(isallerased)
+        uint32_t i = page - firstpage;
+        return (i < numofpages) ? (0 != (burnt[i/32] & (1u << (i%32)))) : false;
+    }
+    
+    void setburnt(std::uint32_t page)
+    {
+        uint32_t i = page - firstpage;
+        if(i < numofpages)
         {
-            return true;
+            burnt[i/32] |= (1u << (i%32));
         }
-        
-        uint32_t firstpage = address2page(start);
-        uint32_t numofpages = address2page(start+size) - firstpage;
-            
+    }
+    
+    bool erasepage(std::uint32_t page)
+    {
         FLASH_EraseInitTypeDef erase = {0};
         erase.TypeErase = FLASH_TYPEERASE_PAGES;
         erase.Banks = FLASH_BANK_1;
-        erase.Page = firstpage;
-        erase.NbPages = numofpages;
+        erase.Page = page;
+        erase.NbPages = 1;
         uint32_t pagenum = 0;
+        int a = HAL_OK;
 #if !defined(TEST_DONT_USE_FLASH)        
         HAL_FLASH_Unlock();
-        int a = HAL_FLASHEx_Erase(&erase, &pagenum);
-        a = a;
+        a = HAL_FLASHEx_Erase(&erase, &pagenum);
         HAL_FLASH_Lock();
 #endif   
      
-        isallerased = true;
-     
-        return true;        
+        return (HAL_OK == a) ? true : false;        
     }
     
-    bool writebuffer()
+    // the 4-bit table of polynomial 0x04c11db7: 64 bytes of rom instead of the 1 KB of the table of hl_crc32.
+    // the bootloader computes a crc only when asked by the host, so the speed is not an issue.
+    static uint32_t crc32(uint32_t crc, const uint8_t *data, uint32_t len)
     {
-        if(false == isallerased)
+        static const uint32_t table[16] = 
+        {
+            0x00000000, 0x04c11db7, 0x09823b6e, 0x0d4326d9, 0x130476dc, 0x17c56b6b, 0x1a864db2, 0x1e475005, 
+            0x2608edb8, 0x22c9f00f, 0x2f8ad6d6, 0x2b4bcb61, 0x350c9b64, 0x31cd86d3, 0x3c8ea00a, 0x384fbdbd
+        };
+        
+        while(len--)
         {
-            eraseall();
+            crc = (crc << 4) ^ table[(crc >> 28) ^ (*data >> 4)];
+            crc = (crc << 4) ^ table[(crc >> 28) ^ (*data & 0x0f)];
+            data++;
         }
         
+        return crc;
+    }
+    
+    void loadbuffer(std::uint32_t page)
+    {
+        if(isburnt(page))
+        {   // it was already written: we start from what is in flash 
+            std::memmove(buffer.data, reinterpret_cast<const void*>(page2address(page)), buffer.size);
+        }
+        else
+        {
+            std::memset(buffer.data, 0xff, buffer.size);
+        }
+        buffer.page = page;
+    }
+    
+    bool writebuffer()
+    {
+        erasepage(buffer.page);
+        
         HAL_FLASH_Unlock();
         
         uint32_t tmpadr = page2address(buffer.page);
@@ -139,6 +180,8 @@ struct embot::hw::FlashBurner::Impl
         xx= xx;
 #endif        
         HAL_FLASH_Lock();  
+        
+        setburnt(buffer.page);
 
         return true;
     }
@@ -180,7 +223,10 @@ struct embot::hw::FlashBurner::Impl
         //buffer.datamirror08 = static_cast<uint8_t*>(buffer.data);
         buffer.datamirror08 = reinterpret_cast<uint8_t*>(buffer.data);
         
-        isallerased = false;
+        firstpage = address2page(start);
+        numofpages = address2page(start+size-1) - firstpage + 1;
+        burnt = new std::uint32_t[(numofpages+31)/32];
+        std::memset(burnt, 0, sizeof(std::uint32_t)*((numofpages+31)/32));
         
 
         HAL_FLASH_Unlock();
@@ -188,6 +234,8 @@ struct embot::hw::FlashBurner::Impl
     
     ~Impl()
     {
+        delete[] burnt;
+        
         if(false == buffer.isexternal)
         {
             delete[] buffer.data;
@@ -223,6 +271,41 @@ bool embot::hw::FlashBurner::isAddressValid(std::uint32_t address)
 }
 
 
+std::uint32_t embot::hw::FlashBurner::pagesize()
+{
+    return Impl::PAGEsize;
+}
+
+
+std::uint32_t embot::hw::FlashBurner::crc32(std::uint32_t address, std::uint32_t size)
+{
+    if(false == isAddressValid(address))
+    {
+        size = 0;
+    }
+    else if(size > (pImpl->start + pImpl->size - address))
+    {
+        size = pImpl->start + pImpl->size - address;
+    }
+    
+    return Impl::crc32(0xffffffff, reinterpret_cast<const uint8_t*>(address), size);
+}
+
+
+bool embot::hw::FlashBurner::invalidate()
+{
+    if(pImpl->firstpage == pImpl->buffer.page)
+    {   // its data must not be written back by a later flush()
+        pImpl->buffer.page = Impl::noPAGE;
+    }
+    
+    // it is not burnt anymore, so that a later add() does not reload its content
+    pImpl->burnt[0] &= ~1u;
+    
+    return pImpl->erasepage(pImpl->firstpage);
+}
+
+
 bool embot::hw::FlashBurner::add(std::uint32_t address, std::uint32_t size, const void *data)
 {
     if(false == isAddressValid(address))
@@ -252,18 +335,13 @@ bool embot::hw::FlashBurner::add(std::uint32_t address, std::uint32_t size, cons
     
     if(dataisinanewpage)
     {   // must process the old page   
-        if(Impl::noPAGE == pImpl->buffer.page)
-        {   // first (valid) data ever. we just erase
-            pImpl->eraseall();
-        }
-        else
-        {   // all other times means that in buffer there is data.
+        if(Impl::noPAGE != pImpl->buffer.page)
+        {   // there is data in buffer: we erase its page and we write it
             pImpl->writebuffer();
         }
         
-        // erase the buffer.data, assign the new page to the buffer
-        std::memset(pImpl->buffer.data, 0xff, pImpl->buffer.size);
-        pImpl->buffer.page = currpagenum;    
+        // prepare the buffer.data for the new page
+        pImpl->loadbuffer(currpagenum);
     }    
         
     if(dataallinside1page)
@@ -282,9 +360,8 @@ bool embot::hw::FlashBurner::add(std::uint32_t address, std::uint32_t size, cons
         // first block: copy from offset and write buffer
         std::memmove(&pImpl->buffer.datamirror08[curroffset], data1, size1); 
         pImpl->writebuffer();
-        // second block: erase buffer, set the new pagenumber, copy at the beginnig
-        std::memset(pImpl->buffer.data, 0xff, pImpl->buffer.size);
-        pImpl->buffer.page = currpagenum+1; 
+        // second block: prepare the buffer for the next page, copy at the beginnig
+        pImpl->loadbuffer(currpagenum+1);
         std::memmove(&pImpl->buffer.datamirror08[0], data2, size2);         
     }    
         
@@ -307,12 +384,6 @@ bool embot::hw::FlashBurner::flush()
 }
 
 
-#if 0
-bool embot::hw::FlashBurner::erase()
-{ 
-    return pImpl->eraseall();
-}
-#endif
 
 
 
@@ -43,6 +43,18 @@ namespace embot { namespace hw {
         //bool erase();
         
         bool isAddressValid(std::uint32_t address);
+        
+        // the size of a page of flash, which is the unit of erase.
+        std::uint32_t pagesize();
+        
+        // the crc32 of the content of flash in [address, address+size), clipped to the managed area. for a non empty range 
+        // it is the one of hl_crc32_compute() with polynomial 0x04c11db7 and initvalue 0xffffffff. if nothing is left after
+        // the clip (size 0 or address outside the area) it is 0xffffffff, whereas hl_crc32_compute() would give 0.
+        // call flush() before, if data was added.
+        std::uint32_t crc32(std::uint32_t address, std::uint32_t size);
+        
+        // it erases the first page of the managed area, so that the application in there is not run anymore.
+        bool invalidate();
       
 
     private:        
@@ -41,31 +41,62 @@
     
 struct embot::hw::FlashStorage::Impl
 {
+    // the layout of a page in use is: PageHeader, then the records one after another, then 0xff up to the end. 
+    // the first record of a page is always the whole content of the storage. 
+    // a record is RecordHeader followed by size bytes of data to be copied at offset. offset and size are multiple of 8.
+    // the header of a page and of a record is programmed after what follows it, so that it is valid only if that is complete.
+    
+    struct PageHeader
+    {
+        uint32_t generation;    // the page in use is the valid one with the highest generation
+        uint32_t check;         // generation ^ magic
+    };
+    
+    struct RecordHeader
+    {
+        uint16_t offset;
+        uint16_t size;
+        uint32_t crc;           // of offset, size and data
+    };
+    
+    static const uint32_t PAGEsize = 2048;    
+    static const uint32_t magic = 0x5aa5c33c;    
+    static const uint32_t noPAGE = 0xffffffff;
+    
     uint64_t *buffer;
-    uint32_t pagenumber;
     uint32_t pagestart;
     uint32_t pagesize;
+    uint32_t numofpages;
     bool bufferisexternal;
     
-    Impl(std::uint32_t _pagestart = embot::hw::sys::addressOfStorage, std::uint32_t _pagesize = 1024, std::uint64_t * _buffer = nullptr) 
+    uint32_t active;            // the page in use, or noPAGE if there is none yet
+    uint32_t generation;        // of the page in use
+    uint32_t tail;              // offset inside the page in use where the next record goes
+    bool mustcompact;           // the page in use cannot take more records (or there is none): next write() copies into a new page
+    bool uselog;                // in Layout::rawpage, the next write() moves the content into the log
+    
+    Impl(std::uint32_t _pagestart = embot::hw::sys::addressOfStorage, std::uint32_t _pagesize = 1024, std::uint64_t * _buffer = nullptr, std::uint32_t _numofpages = 2) 
     {
         pagestart = _pagestart; // dont do any control ... just > embot::hw::sys::startOfFLASH
         if(pagestart < embot::hw::sys::startOfFLASH)
         {
              pagestart = embot::hw::sys::addressOfStorage;
         }
-        pagenumber = (pagestart - embot::hw::sys::startOfFLASH) / 2048; 
         
-        pagesize = _pagesize;
-        if(pagesize > 2048)
+        // the whole content must fit in a page together with the page header and a record header
+        pagesize = _pagesize & ~7u;
+        if(pagesize > (PAGEsize - sizeof(PageHeader) - sizeof(RecordHeader)))
         {
-            pagesize = 2048;
+            pagesize = PAGEsize - sizeof(PageHeader) - sizeof(RecordHeader);
         }
         if(0 == pagesize)
         {
              pagesize = 64;
         }
         
+        // with less than two pages, a power cut during the copy would lose everything
+        numofpages = (_numofpages < 2) ? 2 : _numofpages;
+        
         if(nullptr == _buffer)
         {
             bufferisexternal = false;
@@ -76,6 +107,14 @@ struct embot::hw::FlashStorage::Impl
             bufferisexternal = true;
             buffer = _buffer;
         }
+        
+        active = noPAGE;
+        generation = 0;
+        tail = 0;
+        mustcompact = true;
+        uselog = false;
+        
+        load();
 
         HAL_FLASH_Unlock();
     }
@@ -87,6 +126,251 @@ struct embot::hw::FlashStorage::Impl
             delete[] buffer;
         }
     }
+    
+    static uint32_t crc32(uint32_t crc, const void *data, uint32_t len)
+    {   // polynomial 0x04c11db7, four bits at a time
+        static const uint32_t table[16] = 
+        {
+            0x00000000, 0x04c11db7, 0x09823b6e, 0x0d4326d9, 0x130476dc, 0x17c56b6b, 0x1a864db2, 0x1e475005, 
+            0x2608edb8, 0x22c9f00f, 0x2f8ad6d6, 0x2b4bcb61, 0x350c9b64, 0x31cd86d3, 0x3c8ea00a, 0x384fbdbd
+        };
+        
+        const uint8_t *d = static_cast<const uint8_t*>(data);
+        while(len--)
+        {
+            crc = (crc << 4) ^ table[(crc >> 28) ^ (*d >> 4)];
+            crc = (crc << 4) ^ table[(crc >> 28) ^ (*d & 0x0f)];
+            d++;
+        }
+        
+        return crc;
+    }
+    
+    static uint32_t recordcrc(uint16_t offset, uint16_t size, const void *data)
+    {
+        uint16_t os[2] = {offset, size};
+        return crc32(crc32(0xffffffff, os, sizeof(os)), data, size);
+    }
+    
+    uint32_t pageaddress(uint32_t page) const
+    {
+        return pagestart + PAGEsize*page;
+    }
+    
+    uint8_t * image() const
+    {
+        return reinterpret_cast<uint8_t*>(buffer);
+    }
+    
+    // a double word whose programming was cut by a power loss may give a double ECC error when it is read. the nmi handler 
+    // clears it and counts it in embot::hw::bsp::flashECCDcounter(): if the counter changes during a read, what was read is not valid.
+    static bool isblank(uint32_t address, uint32_t size)
+    {
+        uint32_t eccd = embot::hw::bsp::flashECCDcounter();
+        const uint64_t *p = reinterpret_cast<const uint64_t*>(address);
+        for(uint32_t i=0; i<size/8; i++)
+        {
+            if(0xffffffffffffffffULL != p[i])
+            {
+                return false;
+            }
+        }
+        return (eccd == embot::hw::bsp::flashECCDcounter());
+    }
+    
+    bool isvalid(uint32_t page, uint32_t &gen) const
+    {
+        uint32_t eccd = embot::hw::bsp::flashECCDcounter();
+        const PageHeader *h = reinterpret_cast<const PageHeader*>(pageaddress(page));
+        gen = h->generation;
+        return ((h->generation ^ magic) == h->check) && (eccd == embot::hw::bsp::flashECCDcounter());
+    }
+    
+    bool erasepage(uint32_t page)
+    {
+        FLASH_EraseInitTypeDef erase = {0};
+        erase.TypeErase = FLASH_TYPEERASE_PAGES;
+        erase.Banks = FLASH_BANK_1;
+        erase.Page = (pageaddress(page) - embot::hw::sys::startOfFLASH) / PAGEsize;
+        erase.NbPages = 1;
+        uint32_t pagenum = 0;
+        HAL_FLASH_Unlock();
+        int a = HAL_FLASHEx_Erase(&erase, &pagenum);
+        HAL_FLASH_Lock();
+        return (HAL_OK == a) ? true : false;
+    }
+    
+    bool program(uint32_t address, const uint64_t *data, uint32_t n64bitwords)
+    {
+        bool ok = true;
+        HAL_FLASH_Unlock();
+        for(uint32_t i=0; i<n64bitwords; i++)
+        {
+            if(HAL_OK != HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, address, data[i]))
+            {
+                ok = false;
+                break;
+            }
+            address += 8;
+        }
+        HAL_FLASH_Lock();
+        return ok;
+    }
+    
+    // it writes the record of [offset, offset+size) of the image at position pos of the page. data first and then header.
+    bool append(uint32_t page, uint32_t pos, uint32_t offset, uint32_t size)
+    {
+        uint64_t header = 0;
+        RecordHeader *h = reinterpret_cast<RecordHeader*>(&header);
+        h->offset = offset;
+        h->size = size;
+        h->crc = recordcrc(offset, size, &image()[offset]);
+        
+        if(false == program(pageaddress(page) + pos + sizeof(RecordHeader), &buffer[offset/8], size/8))
+        {
+            return false;
+        }
+        return program(pageaddress(page) + pos, &header, 1);
+    }
+    
+    // it copies the whole image in the page after the one in use, which then becomes the one in use.
+    bool compact()
+    {
+        // if there is no page in use, the first page may still have the raw content of older versions: we keep it untouched.
+        uint32_t target = (noPAGE == active) ? 1 : ((active + 1) % numofpages);
+        
+        if(false == isblank(pageaddress(target), PAGEsize))
+        {
+            if(false == erasepage(target))
+            {
+                return false;
+            }
+        }
+        
+        if(false == append(target, sizeof(PageHeader), 0, pagesize))
+        {
+            return false;
+        }
+        
+        uint64_t header = 0;
+        PageHeader *h = reinterpret_cast<PageHeader*>(&header);
+        h->generation = generation + 1;
+        h->check = h->generation ^ magic;
+        if(false == program(pageaddress(target), &header, 1))
+        {
+            return false;
+        }
+        
+        active = target;
+        generation = h->generation;
+        tail = sizeof(PageHeader) + sizeof(RecordHeader) + pagesize;
+        mustcompact = false;
+        return true;
+    }
+    
+    // it rebuilds the image from the page in use: the first record and then all the others in order.
+    void load()
+    {
+        std::memset(buffer, 0xff, pagesize);
+        
+        for(uint32_t i=0; i<numofpages; i++)
+        {
+            uint32_t gen = 0;
+            if(isvalid(i, gen) && ((noPAGE == active) || (static_cast<int32_t>(gen - generation) > 0)))
+            {
+                active = i;
+                generation = gen;
+            }
+        }
+        
+        if(noPAGE == active)
+        {   // Layout::rawpage: we take the raw content of the first page
+            std::memmove(buffer, reinterpret_cast<const void*>(pagestart), pagesize);
+            mustcompact = true;
+            return;
+        }
+        
+        uint32_t pos = sizeof(PageHeader);
+        while((pos + sizeof(RecordHeader)) <= PAGEsize)
+        {
+            const RecordHeader *h = reinterpret_cast<const RecordHeader*>(pageaddress(active) + pos);
+            if(isblank(pageaddress(active) + pos, sizeof(RecordHeader)))
+            {   // end of the log
+                break;
+            }
+            
+            uint32_t eccd = embot::hw::bsp::flashECCDcounter();
+            const uint8_t *data = reinterpret_cast<const uint8_t*>(h) + sizeof(RecordHeader);
+            bool ok = (0 == (h->offset % 8)) && (0 == (h->size % 8)) && ((h->offset + h->size) <= pagesize) && 
+                      ((pos + sizeof(RecordHeader) + h->size) <= PAGEsize) && (h->crc == recordcrc(h->offset, h->size, data)) &&
+                      (eccd == embot::hw::bsp::flashECCDcounter());
+            if(false == ok)
+            {
+                break;
+            }
+            
+            std::memmove(&image()[h->offset], data, h->size);
+            pos += sizeof(RecordHeader) + h->size;
+        }
+        
+        // after the last record there must be only 0xff, else it is the residual of a record cut by a power loss.
+        tail = pos;
+        mustcompact = !isblank(pageaddress(active) + pos, PAGEsize - pos);
+    }
+    
+    // Layout::rawpage, as older versions did: the image at the start of the first page, which is erased at every write().
+    bool rawwrite()
+    {
+        if(false == erasepage(0))
+        {
+            return false;
+        }
+        return program(pagestart, buffer, pagesize/8);
+    }
+    
+    // it puts [offset, offset+size) of the image into flash with a record which covers the double words which contain it.
+    bool commit(uint32_t offset, uint32_t size)
+    {
+        if((noPAGE == active) && (false == uselog))
+        {
+            return rawwrite();
+        }
+        
+        uint32_t from = offset & ~7u;
+        uint32_t to = (offset + size + 7) & ~7u;
+        
+        if((true == mustcompact) || ((tail + sizeof(RecordHeader) + (to - from)) > PAGEsize))
+        {
+            return compact();
+        }
+        
+        if(false == append(active, tail, from, to - from))
+        {   // what is left in the page cannot be trusted anymore
+            mustcompact = true;
+            return compact();
+        }
+        
+        tail += sizeof(RecordHeader) + (to - from);
+        return true;
+    }
+    
+    bool housekeeping()
+    {
+        if(noPAGE == active)
+        {   // the raw content of the first page is not yet in a log page
+            return true;
+        }
+        
+        bool ok = true;
+        for(uint32_t i=0; i<numofpages; i++)
+        {
+            if((i != active) && (false == isblank(pageaddress(i), PAGEsize)))
+            {
+                ok = erasepage(i) && ok;
+            }
+        }
+        return ok;
+    }
 };
 
 
@@ -95,8 +379,8 @@ struct embot::hw::FlashStorage::Impl
 // --------------------------------------------------------------------------------------------------------------------
 
 
-embot::hw::FlashStorage::FlashStorage(std::uint32_t pagestart, std::uint32_t pagesize, std::uint64_t *buffer)
-: pImpl(new Impl(pagestart, pagesize, buffer))
+embot::hw::FlashStorage::FlashStorage(std::uint32_t pagestart, std::uint32_t pagesize, std::uint64_t *buffer, std::uint32_t numofpages)
+: pImpl(new Impl(pagestart, pagesize, buffer, numofpages))
 {   
 
 }
@@ -137,18 +421,19 @@ std::uint32_t embot::hw::FlashStorage::getSize()
 
 bool embot::hw::FlashStorage::fullerase()
 {
-    // erase page
-    FLASH_EraseInitTypeDef erase = {0};
-    erase.TypeErase = FLASH_TYPEERASE_PAGES;
-    erase.Banks = FLASH_BANK_1;
-    erase.Page = pImpl->pagenumber;
-    erase.NbPages = 1;
-    uint32_t pagenum = 0;
-    HAL_FLASH_Unlock();
-    int a = HAL_FLASHEx_Erase(&erase, &pagenum);
-    a = a;
-    HAL_FLASH_Lock();
-    return true;
+    // erase all the pages. at next load() there is no page in use and the content is all 0xff
+    bool ok = true;
+    for(uint32_t i=0; i<pImpl->numofpages; i++)
+    {
+        ok = pImpl->erasepage(i) && ok;
+    }
+    
+    std::memset(pImpl->buffer, 0xff, pImpl->pagesize);
+    pImpl->active = Impl::noPAGE;
+    pImpl->generation = 0;
+    pImpl->mustcompact = true;
+    
+    return ok;
 }
 
 
@@ -162,8 +447,17 @@ bool embot::hw::FlashStorage::erase(std::uint32_t address, std::uint32_t size)
     {
         return false;
     }
+    
+    if(0 == size)
+    {
+        return true;
+    }
+    
+    // as a write() of 0xff
+    uint32_t offset = address - pImpl->pagestart;
+    std::memset(&pImpl->image()[offset], 0xff, size);
         
-    return false; 
+    return pImpl->commit(offset, size); 
 }
 
 
@@ -183,9 +477,8 @@ bool embot::hw::FlashStorage::read(std::uint32_t address, std::uint32_t size, vo
         return false;
     }
     
-    // can read directly from flash
-    void *st = (void*) address;
-    std::memmove(data, st, size); 
+    // the image is always the same as the content of flash
+    std::memmove(data, &pImpl->image()[address - pImpl->pagestart], size); 
     
     return true;
 }
@@ -206,38 +499,48 @@ bool embot::hw::FlashStorage::write(std::uint32_t address, std::uint32_t size, c
         return false;
     }
     
-    // read all flash with buffer.  
-    if(false == read(pImpl->pagestart, pImpl->pagesize, pImpl->buffer))
-    {
-        return false;
-    }
+    uint32_t offset = address - pImpl->pagestart;
     
-    // change the buffer
-    uint32_t reducedaddress = address - pImpl->pagestart;
-    std::memmove(&pImpl->buffer[reducedaddress/8], data, size);
-    // erase page
-    fullerase();
+    if((0 == size) || (0 == std::memcmp(&pImpl->image()[offset], data, size)))
+    {   // nothing changes
+        return true;
+    }
     
-    HAL_FLASH_Unlock();
+    std::memmove(&pImpl->image()[offset], data, size);
     
-    uint32_t tmpadr = address;
-    uint32_t n64bitwords = pImpl->pagesize / 8;
-    for(uint16_t i=0; i<n64bitwords; i++)
+    return pImpl->commit(offset, size);    
+}
+
+
+bool embot::hw::FlashStorage::housekeeping()
+{
+    return pImpl->housekeeping();
+}
+
+
+embot::hw::FlashStorage::Layout embot::hw::FlashStorage::layout()
+{
+    return (Impl::noPAGE == pImpl->active) ? Layout::rawpage : Layout::log;
+}
+
+
+bool embot::hw::FlashStorage::setlayout(Layout l)
+{
+    if(Layout::log == l)
     {
-        HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, tmpadr, pImpl->buffer[i]);
-        tmpadr += 8;
+        pImpl->uselog = true;
+        return true;
     }
-
-    volatile uint32_t xx =  HAL_FLASH_GetError();
-    
-    xx= xx;
     
-    HAL_FLASH_Lock();
+    if(Impl::noPAGE != pImpl->active)
+    {   // the content is already in the log and we dont go back
+        return false;
+    }
     
-    return true;    
+    pImpl->uselog = false;
+    return true;
 }
 
-
  
 }} // namespace embot { namespace hw {
     
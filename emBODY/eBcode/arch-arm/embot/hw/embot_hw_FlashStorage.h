@@ -28,16 +28,37 @@
 
 namespace embot { namespace hw {
     
+    // it offers pagesize bytes at addresses [pagestart, pagestart+pagesize). the buffer keeps an image of the storage and 
+    // read() copies from it. there are two layouts in flash:
+    // - Layout::rawpage, the one of older versions: the image is at the start of the first page, which write() erases 
+    //   and programs again every time. it is the layout of a new object, unless a log is found in flash.
+    // - Layout::log: a log of records spread over numofpages pages of flash starting at pagestart. write() appends to 
+    //   the page in use a record with only the double words which have changed. when that page is full, its content is 
+    //   copied into the next page, so that the erases go round all the pages. a power cut at any time leaves either the 
+    //   old or the new content of the last write(). a double word which gives a double ECC error is treated as not valid.
+    // the move to Layout::log happens at the first write() after setlayout(Layout::log) and it cannot be undone. as the 
+    // storage is shared by bootloader and application, call setlayout(Layout::log) only when both can read the log.
     class FlashStorage : public embot::i2h::Storage
     {
     public:
+        
+        enum class Layout { rawpage = 0, log = 1 };
+        
         // for ease of life, we keep the address fixed. however, we could use it as a parameter. 
         //static const std::uint32_t PageStart = 0x0801F800; // @126k, page #63
         //static const std::uint32_t PageSize = 1024;
         
-        FlashStorage(std::uint32_t pagestart = embot::hw::sys::addressOfStorage, std::uint32_t pagesize = 1024, std::uint64_t *buffer = nullptr);
+        FlashStorage(std::uint32_t pagestart = embot::hw::sys::addressOfStorage, std::uint32_t pagesize = 1024, std::uint64_t *buffer = nullptr, std::uint32_t numofpages = embot::hw::sys::maxsizeOfStorage/2048);
         ~FlashStorage();
         
+        // it erases the pages not in use, so that the write() which fills the page in use does not have to.
+        // call it when there is time, for instance from a task of low priority. it is never required.
+        bool housekeeping();
+        
+        Layout layout();
+        // it returns false for Layout::rawpage if the content is already in Layout::log.
+        bool setlayout(Layout l);
+        
         virtual bool isInitted();
         virtual bool isAddressValid(std::uint32_t address);
         virtual std::uint32_t getBaseAddress();
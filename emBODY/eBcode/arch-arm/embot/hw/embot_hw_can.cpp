@@ -30,7 +30,6 @@
 // --------------------------------------------------------------------------------------------------------------------
 
 #include <cstring>
-#include <vector>
 
 using namespace std;
 
@@ -63,6 +62,8 @@ namespace embot { namespace hw { namespace can {
     
     result_t put(Port p, const Frame &frame)  { return resNOK; }
     
+    std::uint8_t put(Port p, const Frame *frames, std::uint8_t number)  { return 0; }
+    
     std::uint8_t outputqueuesize(Port p)  { return 0; }
     
     result_t transmit(Port p)  { return resNOK; }
@@ -71,6 +72,20 @@ namespace embot { namespace hw { namespace can {
     
     result_t get(Port p, Frame &frame, std::uint8_t &remaining)  { return resNOK; }    
     
+    std::uint8_t get(Port p, Frame *frames, std::uint8_t maxnumber, std::uint8_t &remaining)  { return 0; }
+    
+    std::uint32_t outputqueueoverflows(Port p) { return 0; }
+    
+    std::uint32_t inputqueueoverflows(Port p) { return 0; }
+    
+    result_t addFilter(Port p, std::uint32_t id, std::uint32_t mask) { return resNOK; }
+    
+    result_t clearFilters(Port p) { return resNOK; }
+    
+    std::uint8_t numberofFilters(Port p) { return 0; }
+    
+    bool accepted(Port p, const Frame &frame) { return false; }
+    
 }}} // namespace embot { namespace hw { namespace can {
 
 #elif   defined(HAL_CAN_MODULE_ENABLED)
@@ -157,19 +172,85 @@ namespace embot { namespace hw { namespace can {
     
     
     static Config s_config;    
-    static std::vector<Frame> *s_Qtx;
-    static std::vector<Frame> *s_rxQ;
+    // the rx queue is filled by the ISR and emptied by the task. the tx queue the other way round (or all by the task in s_transmit_noirq()).
+    // they are rings, so that the time spent in the ISR does not depend on their capacity. the rx one is lock-free, but
+    // the tx one needs CAN_IT_TME masked in put() because its consumer is the ISR.
+    static embot::common::Ring<Frame, maxcapacity> s_Qtx;
+    static embot::common::Ring<Frame, maxcapacity> s_rxQ;
     
     
     //allocate memory for HAL
     static CanTxMsgTypeDef        TxMessage;
     static CanRxMsgTypeDef        RxMessage;
     
-    static void s_transmit_noirq(CAN_HandleTypeDef *hcan)
+    // acceptance filters: the model which is also used to program the bxCAN filter banks
+    static const std::uint8_t s_hwfilterbanks = 14;     // banks [0, 14) are assigned to CAN1 by .BankNumber = 14
+    static Filter s_filters[maxfilters];
+    static std::uint8_t s_numfilters = 0;
+    static bool s_swfiltering = false;                  // true when the filters do not fit the hw banks
+    
+    static bool s_accepted(const Frame &frame)
     {
-        std::uint32_t size = s_Qtx->size();
+        if(0 == s_numfilters)
+        {
+            return true;
+        }
+        for(std::uint8_t i=0; i<s_numfilters; i++)
+        {
+            if(true == s_filters[i].match(frame))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    static void s_configfilterbank(std::uint8_t bank, std::uint32_t id, std::uint32_t mask, bool enable)
+    {   // 32 bit scale: STID[10:0] is in bits [31:21], IDE in bit 2. we always ask for IDE = 0 (standard id) 
+        CAN_FilterConfTypeDef sFilterConfig;
+        sFilterConfig.FilterNumber = bank;
+        sFilterConfig.FilterMode = CAN_FILTERMODE_IDMASK;
+        sFilterConfig.FilterScale = CAN_FILTERSCALE_32BIT;
+        sFilterConfig.FilterIdHigh = (id & 0x7FF) << 5;
+        sFilterConfig.FilterIdLow = 0x0000;
+        sFilterConfig.FilterMaskIdHigh = (mask & 0x7FF) << 5;
+        sFilterConfig.FilterMaskIdLow = (0 == mask) ? 0x0000 : 0x0004;
+        sFilterConfig.FilterFIFOAssignment = 0;
+        sFilterConfig.FilterActivation = (true == enable) ? ENABLE : DISABLE;
+        sFilterConfig.BankNumber = s_hwfilterbanks;
+        HAL_CAN_ConfigFilter(&hcan1, &sFilterConfig);
+    }
+    
+    static void s_programfilters()
+    {
+        s_swfiltering = (s_numfilters > s_hwfilterbanks) ? true : false;
         
-        if(0 == size)
+        if((0 == s_numfilters) || (true == s_swfiltering))
+        {   // bank 0 accepts everything
+            s_configfilterbank(0, 0, 0, true);
+            for(std::uint8_t b=1; b<s_hwfilterbanks; b++)
+            {
+                s_configfilterbank(b, 0, 0, false);
+            }
+            return;
+        }
+        
+        for(std::uint8_t b=0; b<s_hwfilterbanks; b++)
+        {
+            if(b < s_numfilters)
+            {
+                s_configfilterbank(b, s_filters[b].id, s_filters[b].mask, true);
+            }
+            else
+            {
+                s_configfilterbank(b, 0, 0, false);
+            }
+        }        
+    }
+    
+    static void s_transmit_noirq(CAN_HandleTypeDef *hcan)
+    {
+        if(true == s_Qtx.empty())
         {
             if(nullptr != s_config.txqueueempty.callback)
             {
@@ -178,9 +259,9 @@ namespace embot { namespace hw { namespace can {
             return; // resOK;
         }
         
-        for(std::uint32_t i=0; i<size; i++)
+        Frame frame;
+        while(true == s_Qtx.get(frame))
         {
-            const Frame& frame = s_Qtx->at(i);
             hcan->pTxMsg->StdId = frame.id & 0x7FF;
             hcan->pTxMsg->DLC = frame.size;
             std::memmove(hcan->pTxMsg->Data, frame.data, sizeof(hcan->pTxMsg->Data));
@@ -190,15 +271,15 @@ namespace embot { namespace hw { namespace can {
                 s_config.ontxframe.callback(s_config.ontxframe.arg);
             }            
         }
-        
-        s_Qtx->clear();
                     
         return; // resOK;
     }    
 
     static void s_transmit(CAN_HandleTypeDef *hcan)
     {
-        if(0 == s_Qtx->size())
+        Frame frame;
+        
+        if(false == s_Qtx.get(frame))
         {
             __HAL_CAN_DISABLE_IT(hcan, CAN_IT_TME);
             if(nullptr != s_config.txqueueempty.callback)
@@ -208,8 +289,6 @@ namespace embot { namespace hw { namespace can {
             return; // resOK;
         }
         
-        Frame& frame = s_Qtx->front();
-        
         //1) copy frame to hal memory
         hcan->pTxMsg->StdId = frame.id & 0x7FF;
         hcan->pTxMsg->DLC = frame.size;
@@ -226,10 +305,6 @@ namespace embot { namespace hw { namespace can {
             //i should never be here.
             testonly=testonly;
         }
-       
-        //3) remove the frame from tx queue
-        vector<Frame>::iterator b = s_Qtx->begin();
-        s_Qtx->erase(b);
         
         if(nullptr != s_config.ontxframe.callback)
         {
@@ -269,13 +344,13 @@ namespace embot { namespace hw { namespace can {
         rxframe.size = hcan->pRxMsg->DLC;
         memcpy(rxframe.data, hcan->pRxMsg->Data, rxframe.size);
         
-        
-        if(s_rxQ->size() == s_config.rxcapacity)
+        if((true == s_swfiltering) && (false == s_accepted(rxframe)))
         {
-            //remove the oldest frame
-             s_rxQ->erase(s_rxQ->begin());
+            return;
         }
-        s_rxQ->push_back(rxframe);
+        
+        // if full, the ring applies s_config.rxoverflow in constant time
+        s_rxQ.put(rxframe);
         
         if(nullptr != s_config.onrxframe.callback)
         {
@@ -323,29 +398,16 @@ namespace embot { namespace hw { namespace can {
         
         // do whatever else is required .... for instance... init the buffers.
         
-        s_Qtx = new std::vector<Frame>;
-        s_rxQ = new std::vector<Frame>;
-        s_Qtx->reserve(config.txcapacity);
-        s_rxQ->reserve(config.rxcapacity);
+        if((false == s_Qtx.init(config.txcapacity, config.txoverflow)) || (false == s_rxQ.init(config.rxcapacity, config.rxoverflow)))
+        {
+            return resNOK;
+        }
         
         
         
         /*##-2- Configure the CAN Filter ###########################################*/
-        CAN_FilterConfTypeDef sFilterConfig;
-        sFilterConfig.FilterNumber = 0;
-        sFilterConfig.FilterMode = CAN_FILTERMODE_IDMASK;
-        sFilterConfig.FilterScale = CAN_FILTERSCALE_32BIT;
-        sFilterConfig.FilterIdHigh = 0x0000;
-        sFilterConfig.FilterIdLow = 0x0000;
-        sFilterConfig.FilterMaskIdHigh = 0x0000;
-        sFilterConfig.FilterMaskIdLow = 0x0000;
-        sFilterConfig.FilterFIFOAssignment = 0;
-        sFilterConfig.FilterActivation = ENABLE;
-        sFilterConfig.BankNumber = 14;
-        if(HAL_CAN_ConfigFilter(&hcan1, &sFilterConfig) != HAL_OK)
-        {
-        
-        }
+        // with no filters added so far, it accepts every frame
+        s_programfilters();
 
         //////// configure IRQ handler
         stm32hal_can_configCallback_t  embot_can_irqHandlers;
@@ -400,22 +462,45 @@ namespace embot { namespace hw { namespace can {
         {
             return resNOK;
         }  
-        uint8_t tx_is_enabled = __HAL_CAN_IS_ENABLE_IT(&hcan1, CAN_IT_TME);
         
+        // the consumer of s_Qtx is the ISR, which may preempt put() while it overwrites the oldest frame: we mask it.
+        uint8_t tx_is_enabled = __HAL_CAN_IS_ENABLE_IT(&hcan1, CAN_IT_TME);
         __HAL_CAN_DISABLE_IT(&hcan1, CAN_IT_TME);
-        if(s_Qtx->size() == s_config.txcapacity)
+        bool ok = s_Qtx.put(frame);
+        if(tx_is_enabled)
         {
-            s_Qtx->erase(s_Qtx->begin());
+            __HAL_CAN_ENABLE_IT(&hcan1, CAN_IT_TME);
         }
-        // do whatever is needed
         
-        s_Qtx->push_back(frame);
+        return ok ? resOK : resNOK;           
+    }   
+    
+    
+    std::uint8_t embot::hw::can::put(Port p, const Frame *frames, std::uint8_t number)
+    {
+        if((false == initialised(p)) || (nullptr == frames))
+        {
+            return 0;
+        }  
+        
+        // as in put() of a single frame, the ISR which consumes s_Qtx is masked
+        uint8_t tx_is_enabled = __HAL_CAN_IS_ENABLE_IT(&hcan1, CAN_IT_TME);
+        __HAL_CAN_DISABLE_IT(&hcan1, CAN_IT_TME);
+        std::uint8_t n = 0;
+        for(n=0; n<number; n++)
+        {
+            if(false == s_Qtx.put(frames[n]))
+            {
+                break;
+            }
+        }
         if(tx_is_enabled)
+        {
             __HAL_CAN_ENABLE_IT(&hcan1, CAN_IT_TME);
+        }
         
-        return resOK;           
-    }   
-    
+        return n;           
+    }  
     
 
     std::uint8_t embot::hw::can::outputqueuesize(Port p)
@@ -425,13 +510,7 @@ namespace embot { namespace hw { namespace can {
             return 0;
         } 
 
-        uint8_t tx_is_enabled = __HAL_CAN_IS_ENABLE_IT(&hcan1, CAN_IT_TME); 
-        
-        __HAL_CAN_DISABLE_IT(&hcan1, CAN_IT_TME);
-        uint8_t size = s_Qtx->size();
-        if(tx_is_enabled)
-        __HAL_CAN_ENABLE_IT(&hcan1, CAN_IT_TME);
-        return size;
+        return s_Qtx.size();
     }
     
     std::uint8_t embot::hw::can::inputqueuesize(Port p)
@@ -440,12 +519,7 @@ namespace embot { namespace hw { namespace can {
         {
             return 0;
         }  
-        uint32_t size=0;
-
-        __HAL_CAN_DISABLE_IT(&hcan1, CAN_IT_FMP0);
-        size = s_rxQ->size();
-        __HAL_CAN_ENABLE_IT(&hcan1, CAN_IT_FMP0);
-        return size;
+        return s_rxQ.size();
     }
 
     
@@ -478,26 +552,148 @@ namespace embot { namespace hw { namespace can {
             return resNOK;
         } 
         
-        bool empty = true;
-        
-        __HAL_CAN_DISABLE_IT(&hcan1, CAN_IT_FMP0);
-        empty = s_rxQ->empty();
-        __HAL_CAN_ENABLE_IT(&hcan1, CAN_IT_FMP0);
-        
-        if(empty)
+        // no need to disable CAN_IT_FMP0: the ring is safe vs the ISR which fills it
+        if(false == s_rxQ.get(frame))
         {
             remaining = 0;
             return resNOK;
         }
         
-        __HAL_CAN_DISABLE_IT(&hcan1, CAN_IT_FMP0);
-        frame = s_rxQ->front();        
-        s_rxQ->erase(s_rxQ->begin());
-        remaining = s_rxQ->size();
-        __HAL_CAN_ENABLE_IT(&hcan1, CAN_IT_FMP0);
+        remaining = s_rxQ.size();
         
         return resOK;        
     }
+    
+    
+    std::uint8_t embot::hw::can::get(Port p, Frame *frames, std::uint8_t maxnumber, std::uint8_t &remaining)
+    {
+        remaining = 0;
+        
+        if((false == initialised(p)) || (nullptr == frames))
+        {
+            return 0;
+        } 
+        
+        std::uint8_t n = s_rxQ.get(frames, maxnumber);
+        remaining = s_rxQ.size();
+        
+        return n;        
+    }
+    
+    
+    std::uint32_t embot::hw::can::outputqueueoverflows(Port p)
+    {
+        if(false == initialised(p))
+        {
+            return 0;
+        } 
+        
+        return s_Qtx.overflows();
+    }
+    
+    
+    std::uint32_t embot::hw::can::inputqueueoverflows(Port p)
+    {
+        if(false == initialised(p))
+        {
+            return 0;
+        } 
+        
+        return s_rxQ.overflows();
+    }
+    
+    
+    result_t embot::hw::can::addFilter(Port p, std::uint32_t id, std::uint32_t mask)
+    {
+        if((false == supported(p)) || (s_numfilters >= maxfilters))
+        {
+            return resNOK;
+        } 
+        
+        Filter f(id, mask);
+        
+        for(std::uint8_t i=0; i<s_numfilters; i++)
+        {
+            if((s_filters[i].id == f.id) && (s_filters[i].mask == f.mask))
+            {   // already there
+                return resOK;
+            }
+        }
+        
+        // the rx isr must not see a partially filled table
+        bool active = initialised(p);
+        bool rx_is_enabled = active && __HAL_CAN_IS_ENABLE_IT(&hcan1, CAN_IT_FMP0);
+        if(rx_is_enabled)
+        {
+            __HAL_CAN_DISABLE_IT(&hcan1, CAN_IT_FMP0);
+        }
+        
+        s_filters[s_numfilters++] = f;
+        
+        if(active)
+        {
+            s_programfilters();
+        }
+        
+        if(rx_is_enabled)
+        {
+            __HAL_CAN_ENABLE_IT(&hcan1, CAN_IT_FMP0);
+        }
+        
+        return resOK;
+    }
+    
+    
+    result_t embot::hw::can::clearFilters(Port p)
+    {
+        if(false == supported(p))
+        {
+            return resNOK;
+        } 
+        
+        bool active = initialised(p);
+        bool rx_is_enabled = active && __HAL_CAN_IS_ENABLE_IT(&hcan1, CAN_IT_FMP0);
+        if(rx_is_enabled)
+        {
+            __HAL_CAN_DISABLE_IT(&hcan1, CAN_IT_FMP0);
+        }
+        
+        s_numfilters = 0;
+        
+        if(active)
+        {
+            s_programfilters();
+        }
+        
+        if(rx_is_enabled)
+        {
+            __HAL_CAN_ENABLE_IT(&hcan1, CAN_IT_FMP0);
+        }
+        
+        return resOK;
+    }
+    
+    
+    std::uint8_t embot::hw::can::numberofFilters(Port p)
+    {
+        if(false == supported(p))
+        {
+            return 0;
+        } 
+        
+        return s_numfilters;
+    }
+    
+    
+    bool embot::hw::can::accepted(Port p, const Frame &frame)
+    {
+        if(false == supported(p))
+        {
+            return false;
+        } 
+        
+        return s_accepted(frame);
+    }
 
     
     
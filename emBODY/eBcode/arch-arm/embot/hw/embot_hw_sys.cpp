@@ -175,6 +175,102 @@ dowaitloop
     {   
         ss_bsp_delay(t);
     }
+    
+    
+    void startcyclecounter()
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    
+    std::uint32_t cyclecounter()
+    {
+        return DWT->CYCCNT;
+    }
+    
+    std::uint32_t irqdisable()
+    {
+        std::uint32_t state = __get_PRIMASK();
+        __disable_irq();
+        return state;
+    }
+    
+    void irqrestore(std::uint32_t state)
+    {
+        __set_PRIMASK(state);
+    }
+    
+    
+    embot::common::relTime sleep(embot::common::relTime maxtime, embot::common::relTime tickperiod)
+    {
+        if((0 == tickperiod) || (maxtime < 2*tickperiod))
+        {
+            return 0;
+        }
+        
+        // the systick counts down from LOAD to 0 and the rtos was configured with LOAD+1 cycles per tick.
+        // it is 24 bits wide, hence we cannot sleep for more than maxticks.
+        const std::uint32_t cyclespertick = SysTick->LOAD + 1;
+        const std::uint32_t maxticks = SysTick_LOAD_RELOAD_Msk / cyclespertick;
+        std::uint32_t ticks = maxtime / tickperiod;
+        ticks = (ticks > maxticks) ? maxticks : ticks;
+        if(ticks < 2)
+        {
+            return 0;
+        }
+        
+        // the interrupts are disabled so that wfi returns when any of them is pending but none is served 
+        // until we have restored the systick.
+        __disable_irq();
+        
+        SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+        // we sleep what remains of the current tick plus (ticks-1) full ticks so that the tick boundaries stay aligned
+        const std::uint32_t remaining = (0 == SysTick->VAL) ? cyclespertick : SysTick->VAL;
+        const std::uint32_t load = remaining + (ticks-1)*cyclespertick;
+        SysTick->LOAD = load - 1;
+        SysTick->VAL = 0;
+        // we also enable its interrupt (the rtos has disabled it when suspended) so that its expiry wakes us up
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+        
+        __DSB();
+        __WFI();
+        __ISB();
+        
+        // reading CTRL clears COUNTFLAG, hence we read it only once
+        const std::uint32_t ctrl = SysTick->CTRL;
+        SysTick->CTRL = ctrl & ~(SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk);
+        
+        std::uint32_t slept = ticks;
+        std::uint32_t tonexttick = cyclespertick;
+        if(0 == (ctrl & SysTick_CTRL_COUNTFLAG_Msk))
+        {   // another interrupt has woken us up before the expiry: we count only the completed ticks
+            const std::uint32_t elapsed = load - SysTick->VAL;
+            if(elapsed < remaining)
+            {
+                slept = 0;
+                tonexttick = remaining - elapsed;
+            }
+            else
+            {
+                slept = 1 + (elapsed - remaining) / cyclespertick;
+                tonexttick = cyclespertick - ((elapsed - remaining) % cyclespertick);
+            }
+        }
+        
+        // the first reload happens at the next tick boundary, then the normal LOAD is used again
+        SysTick->LOAD = tonexttick - 1;
+        SysTick->VAL = 0;
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+        SysTick->LOAD = cyclespertick - 1;
+        
+        // the systick expiry must not be served: the rtos accounts for the slept ticks in its resume
+        SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+        
+        __enable_irq();
+        
+        return slept*tickperiod;
+    }
       
     static const std::uint32_t maxRANDmask = 0x3ff; // 1023    
     std::uint32_t random()
@@ -30,10 +30,7 @@
 // - external dependencies
 // --------------------------------------------------------------------------------------------------------------------
 
-#include "EOtimer.h"
-#include "EOVtheCallbackManager.h"
-
-#include "embot_sys_Task.h"
+#include "embot_sys_theTimerManager.h"
 
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -43,14 +40,15 @@
     
 struct embot::sys::Timer::Impl
 {
-    EOtimer *tmr;
+    TimingWheel::Node node;     // it is linked into the timing wheel of theTimerManager, hence no memory is allocated at start()
+    Type type;
     Impl() 
     {
-        tmr = eo_timer_New();
+        type = Type::oneshot;
     }
     ~Impl()
     {
-        eo_timer_Delete(tmr);
+        theTimerManager::getInstance().remove(node);
     }
 };
 
@@ -75,64 +73,33 @@ embot::sys::Timer::~Timer()
 
 bool embot::sys::Timer::start(common::relTime countdown, Type type, Action &onexpiry)
 {
-    EOaction_strg strg = {0};
-    EOaction* action = (EOaction*)&strg;
-    EOVtaskDerived *totask = NULL;
+    theTimerManager &tm = theTimerManager::getInstance();
     
-    switch(onexpiry.type)
-    {
-        case Action::Type::event2task:
-        {            
-            if(NULL != onexpiry.evt.task)
-            {
-                totask = (EOVtaskDerived*) onexpiry.evt.task->getEOMtask();
-            }
-            eo_action_SetEvent(action, onexpiry.evt.event, totask);
-        } break;
-        case Action::Type::message2task:
-        {
-            if(NULL != onexpiry.msg.task)
-            {
-                totask = (EOVtaskDerived*) onexpiry.msg.task->getEOMtask();
-            }
-            eo_action_SetMessage(action, onexpiry.msg.message, totask);
-        } break;
-        
-        case Action::Type::executecallback:
-        {
-            totask = eov_callbackman_GetTask(eov_callbackman_GetHandle());
-            eo_action_SetCallback(action, onexpiry.cbk.callback.callback, onexpiry.cbk.callback.arg, totask);
-        } break;  
-        
-        default:
-        {
-            eo_action_Clear(action);
-        } break;
-    } 
+    // we must remove it before we change the action, because the manager may be expiring it
+    tm.remove(pImpl->node);
+    
+    pImpl->type = type;
+    pImpl->node.action = onexpiry;
     
-    eOresult_t r = eo_timer_Start(pImpl->tmr, eok_abstimeNOW, countdown, static_cast<eOtimerMode_t>(type), action);    
-    return (eores_OK == r) ? true : false;
+    return tm.add(pImpl->node, countdown, (Type::forever == type));
 }
 
 
 bool embot::sys::Timer::stop()
 {
-    eOresult_t r = eo_timer_Stop(pImpl->tmr);    
-    return (eores_OK == r) ? true : false;
+    return theTimerManager::getInstance().remove(pImpl->node);
 }
 
 
 embot::sys::Timer::Status embot::sys::Timer::getStatus()
 {
-    eOtimerStatus_t st = eo_timer_GetStatus(pImpl->tmr);    
-    return static_cast<Timer::Status>(st);   
+    return static_cast<Timer::Status>(pImpl->node.status);   
 }
 
 
 embot::sys::Timer::Type embot::sys::Timer::getType()
 {
-    eOtimerMode_t mode = eo_timer_GetMode(pImpl->tmr);    
-    return static_cast<Timer::Type>(mode);   
+    return pImpl->type;   
 }
 
 
@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * Author:  agent
+ * email:   agent@local
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - public interface
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "embot_sys_TimingWheel.h"
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - external dependencies
+// --------------------------------------------------------------------------------------------------------------------
+
+// empty-section
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - all the rest
+// --------------------------------------------------------------------------------------------------------------------
+
+const std::uint8_t embot::sys::TimingWheel::levels;
+const std::uint8_t embot::sys::TimingWheel::slotbits;
+const std::uint8_t embot::sys::TimingWheel::slots;
+const std::uint64_t embot::sys::TimingWheel::never;
+
+
+embot::sys::TimingWheel::TimingWheel()
+: now(0), count(0)
+{
+    for(std::uint8_t l=0; l<levels; l++)
+    {
+        for(std::uint8_t s=0; s<slots; s++)
+        {
+            wheel[l][s] = nullptr;
+        }
+    }
+}
+
+
+std::uint64_t embot::sys::TimingWheel::current() const
+{
+    return now;
+}
+
+
+bool embot::sys::TimingWheel::resynch(std::uint64_t tick)
+{
+    if(0 != count)
+    {
+        return false;
+    }
+
+    if(now <= tick)
+    {
+        now = tick + 1;
+    }
+
+    return true;
+}
+
+
+std::uint32_t embot::sys::TimingWheel::size() const
+{
+    return count;
+}
+
+
+std::uint64_t embot::sys::TimingWheel::nextexpiry() const
+{
+    if(0 == count)
+    {
+        return never;
+    }
+
+    std::uint64_t earliest = never;
+
+    // level 0 holds the nodes which expire in [now, now+63] and it gives the exact tick
+    for(std::uint8_t k=0; k<slots; k++)
+    {
+        if(nullptr != wheel[0][(now+k) & (slots-1)])
+        {
+            earliest = now + k;
+            break;
+        }
+    }
+
+    // the upper levels give the tick of their next cascade. the slot of the current group was already cascaded
+    // unless now is exactly at its beginning
+    for(std::uint8_t l=1; l<levels; l++)
+    {
+        const std::uint8_t shift = l*slotbits;
+        const std::uint64_t group = now >> shift;
+        const std::uint8_t first = (0 == (now & ((static_cast<std::uint64_t>(1) << shift) - 1))) ? 0 : 1;
+        for(std::uint8_t d=first; d<=slots; d++)
+        {
+            if(nullptr != wheel[l][(group+d) & (slots-1)])
+            {
+                const std::uint64_t t = (group+d) << shift;
+                earliest = (t < earliest) ? t : earliest;
+                break;
+            }
+        }
+    }
+
+    return earliest;
+}
+
+
+bool embot::sys::TimingWheel::insert(Node *node, std::uint64_t expiry, std::uint32_t period)
+{
+    if(nullptr == node)
+    {
+        return false;
+    }
+
+    if(nullptr != node->head)
+    {   // it is a restart
+        unlink(node);
+        count--;
+    }
+
+    node->expiry = expiry;
+    node->period = period;
+    node->status = Status::counting;
+    link(node);
+    count++;
+
+    return true;
+}
+
+
+bool embot::sys::TimingWheel::remove(Node *node)
+{
+    if(nullptr == node)
+    {
+        return false;
+    }
+
+    if(nullptr != node->head)
+    {
+        unlink(node);
+        count--;
+    }
+
+    node->status = Status::idle;
+
+    return true;
+}
+
+
+std::uint32_t embot::sys::TimingWheel::advance(std::uint64_t tick, Action *actions, std::uint32_t capacity)
+{
+    std::uint32_t n = 0;
+
+    while(now <= tick)
+    {
+        if(0 == count)
+        {   // nothing to expire: we can jump ahead
+            now = tick + 1;
+            break;
+        }
+
+        const std::uint8_t index = now & (slots-1);
+
+        if(0 == index)
+        {   // the nodes of the upper levels which fall in the next 64 ticks go down one level.
+            // it can happen twice for the same tick if we exit for lack of capacity, but it is harmless.
+            for(std::uint8_t l=1; l<levels; l++)
+            {
+                const std::uint8_t i = (now >> (l*slotbits)) & (slots-1);
+                cascade(l, i);
+                if(0 != i)
+                {
+                    break;
+                }
+            }
+        }
+
+        while(nullptr != wheel[0][index])
+        {
+            if(n >= capacity)
+            {   // we stay on this tick: the remaining nodes will be processed at next call
+                return n;
+            }
+
+            Node *node = wheel[0][index];
+            unlink(node);
+            actions[n++] = node->action;
+
+            if(0 != node->period)
+            {   // periodic: keep the phase but skip the periods which are already past, so that a late call of
+                // advance() does not fire the node several times in a burst
+                node->expiry += node->period;
+                if(node->expiry <= tick)
+                {
+                    node->expiry += ((tick - node->expiry) / node->period + 1) * node->period;
+                }
+                link(node);
+            }
+            else
+            {
+                node->status = Status::oneshotcompleted;
+                count--;
+            }
+        }
+
+        now++;
+    }
+
+    return n;
+}
+
+
+void embot::sys::TimingWheel::link(Node *node)
+{
+    static const std::uint64_t maxdelta = (static_cast<std::uint64_t>(1) << (levels*slotbits)) - 1;
+
+    std::uint64_t e = (node->expiry < now) ? now : node->expiry;
+    std::uint64_t delta = e - now;
+    if(delta > maxdelta)
+    {   // it is parked in the last level. it will be placed again when it cascades
+        delta = maxdelta;
+        e = now + maxdelta;
+    }
+
+    std::uint8_t level = 0;
+    while((level < (levels-1)) && (delta >= (static_cast<std::uint64_t>(1) << ((level+1)*slotbits))))
+    {
+        level++;
+    }
+
+    Node **head = &wheel[level][(e >> (level*slotbits)) & (slots-1)];
+
+    node->head = head;
+    node->prev = nullptr;
+    node->next = *head;
+    if(nullptr != *head)
+    {
+        (*head)->prev = node;
+    }
+    *head = node;
+}
+
+
+void embot::sys::TimingWheel::unlink(Node *node)
+{
+    if(nullptr != node->prev)
+    {
+        node->prev->next = node->next;
+    }
+    else
+    {
+        *(node->head) = node->next;
+    }
+
+    if(nullptr != node->next)
+    {
+        node->next->prev = node->prev;
+    }
+
+    node->prev = node->next = nullptr;
+    node->head = nullptr;
+}
+
+
+void embot::sys::TimingWheel::cascade(std::uint8_t level, std::uint8_t index)
+{
+    // we detach the whole slot first because a node may be linked again into the same slot
+    Node *node = wheel[level][index];
+    wheel[level][index] = nullptr;
+
+    while(nullptr != node)
+    {
+        Node *next = node->next;
+        link(node);
+        node = next;
+    }
+}
+
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * Author:  agent
+ * email:   agent@local
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+// - include guard ----------------------------------------------------------------------------------------------------
+
+#ifndef _EMBOT_SYS_TIMINGWHEEL_H_
+#define _EMBOT_SYS_TIMINGWHEEL_H_
+
+#include "embot_common.h"
+
+#include "embot_sys_Action.h"
+
+namespace embot { namespace sys {
+
+    // a hierarchical timing wheel with four levels of 64 slots each: it covers 2^24 ticks, longer delays are
+    // parked in the last level and re-inserted when they cascade. time is expressed in ticks of the wheel and it is
+    // the user who decides their duration (theTimerManager uses its resolution).
+    // - insert() and remove() are O(1), advance() is O(1) for each expired node plus a cascade every 64 ticks.
+    // - the nodes are intrusive (they live inside embot::sys::Timer) hence the wheel never allocates memory.
+    // - the wheel does not execute the actions: advance() copies the actions of all the expired nodes into a
+    //   buffer given by the caller, so that they can be executed all together out of any critical section.
+    // - the wheel is not protected vs concurrent access: it is a task of the caller.
+
+    class TimingWheel
+    {
+    public:
+
+        enum class Status : std::uint8_t { idle = 0, counting = 1, oneshotcompleted = 2 };
+
+        struct Node
+        {
+            Node            *prev;
+            Node            *next;
+            Node            **head;         // the slot which holds the node. it is nullptr if the node is not in the wheel
+            std::uint64_t   expiry;         // in ticks
+            std::uint32_t   period;         // in ticks. if zero the node is oneshot
+            Status          status;
+            Action          action;
+            Node() : prev(nullptr), next(nullptr), head(nullptr), expiry(0), period(0), status(Status::idle) {}
+        };
+
+        static const std::uint8_t levels = 4;
+        static const std::uint8_t slotbits = 6;
+        static const std::uint8_t slots = 1 << slotbits;
+        static const std::uint64_t never = 0xffffffffffffffff;
+
+        TimingWheel();
+
+        // it adds node to the wheel so that it expires at tick expiry (if expiry is in the past, at the next advance()).
+        // if period is not zero, the node is re-inserted at every expiry with expiry += period.
+        bool insert(Node *node, std::uint64_t expiry, std::uint32_t period);
+
+        // it removes the node from the wheel and sets it idle.
+        bool remove(Node *node);
+
+        // it processes all the ticks up to tick (included) and copies the actions of the expired nodes into actions[].
+        // it returns the number of copied actions. if the returned value is equal to capacity, there may be more
+        // expired nodes: in such a case advance() must be called again.
+        std::uint32_t advance(std::uint64_t tick, Action *actions, std::uint32_t capacity);
+
+        // the first tick which is not processed yet
+        std::uint64_t current() const;
+        
+        // if the wheel is empty, it moves current() past tick as advance(tick) would do. call it before insert() when 
+        // advance() may have not been called for long, else the next advance() walks all the ticks in between one by one.
+        // it returns false and does nothing if the wheel is not empty.
+        bool resynch(std::uint64_t tick);
+        
+        // the first tick at which advance() has something to do: either an expiry or a cascade from the upper levels.
+        // hence it is a lower bound of the earliest expiry and it is never if the wheel is empty. it costs at most 
+        // levels*slots checks, so it can be used to decide how long the caller can sleep.
+        std::uint64_t nextexpiry() const;
+
+        // the number of nodes in the wheel
+        std::uint32_t size() const;
+
+    private:
+
+        void link(Node *node);
+        void unlink(Node *node);
+        void cascade(std::uint8_t level, std::uint8_t index);
+
+        Node            *wheel[levels][slots];
+        std::uint64_t   now;
+        std::uint32_t   count;
+    };
+
+
+}} // namespace embot { namespace sys {
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
@@ -70,6 +70,7 @@ struct embot::sys::theScheduler::Impl
     {
         embot::sys::theScheduler &thesystem = embot::sys::theScheduler::getInstance();        
         common::fpWorker onidle = thesystem.pImpl->osalIdleActivity;
+        fpSleep sleep = thesystem.pImpl->sleep;
         
         for(;;)
         {
@@ -77,9 +78,41 @@ struct embot::sys::theScheduler::Impl
             {
                 onidle();
             }
+            
+            if(nullptr != sleep)
+            {
+                thesystem.pImpl->tickless(sleep);
+            }
         }
     } 
     
+    // the rtos tells the time to its next deadline (a task delay or timeout, an osal timer, hence also the wake up of 
+    // theTimerManager). if far enough, we stop the tick up to it. any interrupt wakes us up earlier.
+    void tickless(fpSleep sleep)
+    {
+        statistics.idlecycles++;
+        
+        const osal_reltime_t next = osal_system_suspend();
+        common::relTime slept = 0;
+        
+        if(next >= minsleep)
+        {
+            slept = sleep(next, osalConfig.tick);
+            if(0 != slept)
+            {
+                statistics.sleeps++;
+                statistics.timeslept += slept;
+                statistics.longestsleep = (slept > statistics.longestsleep) ? slept : statistics.longestsleep;
+                if(slept < (next / osalConfig.tick) * osalConfig.tick)
+                {
+                    statistics.earlywakeups++;
+                }
+            }
+        }
+        
+        osal_system_resume(slept);
+    }
+    
     static void osalOnFatalError(void* task, osal_fatalerror_t errorcode, const char * errormsg)
     {
         embot::sys::theScheduler &thesystem = embot::sys::theScheduler::getInstance();        
@@ -97,6 +130,9 @@ struct embot::sys::theScheduler::Impl
     common::fpWorker osalLauncher;
     common::fpWorker osalIdleActivity;   
     common::fpWorker osalFatalErrorActivity;
+    fpSleep sleep;
+    common::relTime minsleep;
+    Statistics statistics;
     
              
     static void osalDefaultLauncher(void) 
@@ -131,6 +167,8 @@ struct embot::sys::theScheduler::Impl
         osalIdleActivity = nullptr;
         osalFatalErrorActivity = nullptr;
         osalLauncher = nullptr;
+        sleep = nullptr;
+        minsleep = 0;
     }
 };
 
@@ -180,6 +218,9 @@ bool embot::sys::theScheduler::init(Config &config)
     
     pImpl->osalFatalErrorActivity = config.onfatalerror;
     
+    pImpl->sleep = config.sleep;
+    pImpl->minsleep = (0 == config.minsleep) ? (2*config.ticktime) : config.minsleep;
+    
     
     return true;    
 }
@@ -206,6 +247,12 @@ bool embot::sys::theScheduler::isStarted()
     return pImpl->started;
 }
 
+bool embot::sys::theScheduler::getStatistics(Statistics &stats)
+{
+    stats = pImpl->statistics;
+    return true;
+}
+
 //embot::common::relTime embot::sys::theScheduler::getTick()
 //{
 //    return pImpl->osalConfig.tick;
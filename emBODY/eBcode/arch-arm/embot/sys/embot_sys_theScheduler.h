@@ -37,6 +37,11 @@ namespace embot { namespace sys {
         }
         
     public:
+        // it must stop the tick of the rtos and wait for at most maxtime (or less if an interrupt comes). it is called by 
+        // the idle task with the scheduler suspended and it returns the slept time, which must be a multiple of tickperiod.
+        // embot::hw::sys::sleep() is the implementation for the cortex-m systick.
+        using fpSleep = common::relTime (*)(common::relTime maxtime, common::relTime tickperiod);
+        
         struct Config
         {
             std::uint32_t       clockfrequency;
@@ -45,26 +50,43 @@ namespace embot { namespace sys {
             std::uint16_t       launcherstacksize;
             common::fpWorker    onidle;
             std::uint16_t       onidlestacksize;
-            common::fpWorker    onfatalerror;     
+            common::fpWorker    onfatalerror;   
+            fpSleep             sleep;          // if not nullptr the scheduler is tickless: the idle task stops the tick up to the next deadline
+            common::relTime     minsleep;       // the idle task does not stop the tick if the next deadline is closer than that. if 0: two ticks
             Config() 
             {
                 clockfrequency = 168000000; ticktime = 1000; 
                 launcher = nullptr; launcherstacksize = 1024; 
                 onidle = nullptr; onidlestacksize = 512;
                 onfatalerror = nullptr;
+                sleep = nullptr; minsleep = 0;
             }
             void setTiming(std::uint32_t _clockfrequency, common::relTime _ticktime = 1000) { clockfrequency = _clockfrequency; ticktime = _ticktime; }
             void setLauncher(common::fpWorker _launcher, std::uint16_t _launcherstacksize = 1024) { launcher = _launcher; launcherstacksize = _launcherstacksize; }
             void setOnIdle(common::fpWorker _onidle, std::uint16_t _onidlestacksize = 512) { onidle = _onidle; onidlestacksize = _onidlestacksize; }
             void setOnFatal(common::fpWorker _onfatalerror) { onfatalerror = _onfatalerror; }
+            void setTickless(fpSleep _sleep, common::relTime _minsleep = 0) { sleep = _sleep; minsleep = _minsleep; }
         }; 
         
+        // the statistics of the tickless mode. 
+        struct Statistics
+        {
+            std::uint32_t       idlecycles;     // how many times the idle task has checked the next deadline
+            std::uint32_t       sleeps;         // how many times it has stopped the tick
+            std::uint32_t       earlywakeups;   // how many sleeps were interrupted before the deadline (e.g., by an isr)
+            common::Time        timeslept;      // the total time spent without tick
+            common::relTime     longestsleep;
+            Statistics() : idlecycles(0), sleeps(0), earlywakeups(0), timeslept(0), longestsleep(0) {}
+        };
+        
         bool init(Config &config);  // can be called many times but not after start(). if so, it does nothing
         
         void start();    // it does not return ... unless the scheduler is already started
         
         bool isStarted();
         
+        bool getStatistics(Statistics &stats);
+        
 //        common::relTime getTick();
 
     private:
@@ -29,6 +29,12 @@
 // --------------------------------------------------------------------------------------------------------------------
 
 #include "EOMtheTimerManager.h"
+#include "EOMtheCallbackManager.h"
+#include "EOMtask.h"
+
+#include "embot_sys_Task.h"
+
+#include "osal.h"
 
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -37,8 +43,15 @@
 
 struct embot::sys::theTimerManager::Impl
 {    
+    static const std::uint8_t batchcapacity = 8;
+    static const common::Event evtWAKEUP = 0x00000001;
+    
     bool started;
     Config config;
+    EventTask *task;
+    osal_timer_t *wakeup;
+    TimingWheel wheel;
+    Action batch[batchcapacity];
     
     Impl() 
     {              
@@ -46,9 +59,121 @@ struct embot::sys::theTimerManager::Impl
         config.capacityofhandler =8;
         config.priority = 240;
         config.stacksize = 1024;
+        config.resolution = common::time1millisec;
+        task = nullptr;
+        wakeup = nullptr;
+    }
+    
+    // before start() there is no other task which can use the wheel
+    void lock() { if(true == started) { osal_system_scheduling_suspend(); } }
+    void unlock() { if(true == started) { osal_system_scheduling_restart(); } }
+    
+    std::uint64_t totick(common::Time t) const { return (t + config.resolution - 1) / config.resolution; }
+    
+    static void execute(const Action &action)
+    {
+        switch(action.type)
+        {
+            case Action::Type::event2task:
+            {
+                if(nullptr != action.evt.task)
+                {
+                    action.evt.task->setEvent(action.evt.event);
+                }
+            } break;
+            
+            case Action::Type::message2task:
+            {
+                if(nullptr != action.msg.task)
+                {
+                    action.msg.task->setMessage(action.msg.message, common::timeWaitNone);
+                }
+            } break;
+            
+            case Action::Type::executecallback:
+            {   // as in the EOtimer: the callback is executed by the callback manager
+                if(nullptr != action.cbk.callback.callback)
+                {
+                    eom_callbackman_Execute(eom_callbackman_GetHandle(), action.cbk.callback.callback, action.cbk.callback.arg, 0);
+                }
+            } break;
+            
+            default:
+            {
+            } break;
+        }
+    }
+    
+    static void onwakeup(osal_timer_t *tmr, void *param)
+    {   // it is executed by the rtos in isr context
+        Impl *impl = static_cast<Impl*>(param);
+        eom_task_isrSetEvent(static_cast<EOMtask*>(impl->task->getEOMtask()), evtWAKEUP);
+    }
+    
+    // all the timers expired up to tick are processed in one go. their actions are copied under lock 
+    // and executed after it is released
+    void process(std::uint64_t tick)
+    {
+        std::uint32_t n = 0;
+        do
+        {
+            lock();
+            n = wheel.advance(tick, batch, batchcapacity);
+            unlock();
+            
+            for(std::uint32_t i=0; i<n; i++)
+            {
+                execute(batch[i]);
+            }
+            
+        } while(batchcapacity == n);
+    }
+    
+    // it is executed by the task of the manager when the wake-up osal timer expires or when a timer is started.
+    // the task does not wake up at every tick: after the processing it sleeps until the next expiry of the wheel,
+    // so that it does not prevent the tickless idle of theScheduler.
+    static void onevent(Task *t, common::EventMask eventmask, void *param)
+    {
+        Impl *impl = static_cast<Impl*>(param);
+        
+        for(;;)
+        {
+            impl->process(timeNow() / impl->config.resolution);
+            
+            impl->lock();
+            const std::uint64_t next = impl->wheel.nextexpiry();
+            impl->unlock();
+            
+            if(TimingWheel::never == next)
+            {
+                osal_timer_stop(impl->wakeup, osal_callerTSK);
+                return;
+            }
+            
+            const common::Time deadline = next * impl->config.resolution;
+            const common::Time now = timeNow();
+            if(deadline > now)
+            {   // the osal timer counts in ticks of the rtos: we round up so that we never wake up too early
+                const common::relTime tick = tickPeriod();
+                osal_timer_timing_t timing;
+                timing.startat = osal_abstimeNONE;
+                timing.count = static_cast<osal_reltime_t>(((deadline - now) + tick - 1) / tick * tick);
+                timing.mode = osal_tmrmodeONESHOT;
+                osal_timer_onexpiry_t onexpiry;
+                onexpiry.cbk = onwakeup;
+                onexpiry.par = impl;
+                osal_timer_stop(impl->wakeup, osal_callerTSK);
+                osal_timer_start(impl->wakeup, &timing, &onexpiry, osal_callerTSK);
+                return;
+            }
+            // else: the next expiry is already due. we process it
+        }
     }
 };
 
+const std::uint8_t embot::sys::theTimerManager::Impl::batchcapacity;
+const embot::common::Event embot::sys::theTimerManager::Impl::evtWAKEUP;
+
 
 // --------------------------------------------------------------------------------------------------------------------
 // - all the rest
@@ -82,8 +207,12 @@ bool embot::sys::theTimerManager::start()
         return false;
     }
     
-    pImpl->started = true;
+    if(0 == pImpl->config.resolution)
+    {
+        pImpl->config.resolution = common::time1millisec;
+    }
     
+    // the legacy manager is still required by the EOtimer objects used inside embobj
     eOmtimerman_cfg_t cfg = {0};
     cfg.messagequeuesize = pImpl->config.capacityofhandler;
     cfg.priority = pImpl->config.priority;
@@ -91,10 +220,59 @@ bool embot::sys::theTimerManager::start()
     
     eom_timerman_Initialise(&cfg);
     
+    // the task of the timing wheel: it wakes up only when there is something to expire
+    pImpl->wakeup = osal_timer_new();
+    pImpl->task = new EventTask(nullptr, pImpl->onevent, pImpl->config.stacksize, pImpl->config.priority, common::timeWaitForever, pImpl, nullptr);
+    // it processes the timers which were started before start()
+    pImpl->task->setEvent(Impl::evtWAKEUP);
+    
+    pImpl->started = true;
+    
     return true;
     
 }
 
+
+bool embot::sys::theTimerManager::add(TimingWheel::Node &node, common::relTime countdown, bool periodic)
+{
+    if(0 == countdown)
+    {
+        return false;
+    }
+    
+    const common::relTime res = pImpl->config.resolution;
+    std::uint32_t period = 0;
+    if(true == periodic)
+    {
+        period = (countdown + res/2) / res;
+        period = (0 == period) ? 1 : period;
+    }
+    
+    pImpl->lock();
+    const common::Time now = timeNow();
+    // after a time without timers the wheel may lag behind: we move it to now, so that process() does not walk all the ticks in between
+    pImpl->wheel.resynch(now / res);
+    bool r = pImpl->wheel.insert(&node, pImpl->totick(now + countdown), period);
+    pImpl->unlock();
+    
+    if(true == pImpl->started)
+    {   // the task may sleep until a later expiry: it must recompute it
+        pImpl->task->setEvent(Impl::evtWAKEUP);
+    }
+    
+    return r;
+}
+
+
+bool embot::sys::theTimerManager::remove(TimingWheel::Node &node)
+{
+    pImpl->lock();
+    bool r = pImpl->wheel.remove(&node);
+    pImpl->unlock();
+    
+    return r;
+}
+
     
 
 // - end-of-file (leave a blank line after)----------------------------------------------------------------------------
@@ -25,6 +25,8 @@
 
 #include "embot_sys.h"
 
+#include "embot_sys_TimingWheel.h"
+
 namespace embot { namespace sys {
     
     
@@ -41,15 +43,20 @@ namespace embot { namespace sys {
     public:
         struct Config
         {
-            std::uint8_t        priority;
-            std::uint16_t       stacksize;
-            std::uint16_t       capacityofhandler;          
-            Config() : priority(240), stacksize(1024), capacityofhandler(8) {}
+            std::uint8_t            priority;
+            std::uint16_t           stacksize;
+            std::uint16_t           capacityofhandler;      // it is used only by the legacy EOtimer objects of embobj
+            common::relTime         resolution;             // the tick of the timing wheel which runs the embot::sys::Timer objects
+            Config() : priority(240), stacksize(1024), capacityofhandler(8), resolution(common::time1millisec) {}
         }; 
         
         bool init(Config &config);
         
         bool start();    
+        
+        // they are used by embot::sys::Timer. they can be called also before start(). 
+        bool add(TimingWheel::Node &node, common::relTime countdown, bool periodic);
+        bool remove(TimingWheel::Node &node);
 
     private:
         theTimerManager();  
@@ -245,6 +245,75 @@ struct embot::tools::PeriodValidator::Impl
 
 
 
+struct embot::tools::TraceDecoder::Impl
+{  
+    std::vector<Item>   items;
+    std::uint64_t       khz;
+    std::uint64_t       base;       // the unwrapped value of the last stamp
+    std::uint32_t       last;       // the last stamp as received
+    bool                first;
+    std::uint64_t       lostrecords;
+
+    Impl() 
+    { 
+        reset();
+    }
+    
+    bool reset()
+    {
+        items.clear();
+        khz = 0;
+        base = 0;
+        last = 0;
+        first = true;
+        lostrecords = 0;
+        return true;
+    }
+    
+    bool add(const std::uint8_t *data08, std::uint8_t size)
+    {
+        if((nullptr == data08) || (size < 8))
+        {
+            return false;
+        }
+        
+        Item item;
+        const std::uint32_t stamp = static_cast<std::uint32_t>(data08[0]) | (static_cast<std::uint32_t>(data08[1]) << 8) | 
+                                    (static_cast<std::uint32_t>(data08[2]) << 16) | (static_cast<std::uint32_t>(data08[3]) << 24);
+        item.event = data08[4];
+        item.arg = static_cast<std::uint32_t>(data08[5]) | (static_cast<std::uint32_t>(data08[6]) << 8) | (static_cast<std::uint32_t>(data08[7]) << 16);
+        
+        if(true == first)
+        {
+            base = stamp;
+            first = false;
+        }
+        else
+        {   // the unsigned difference takes care of the wrap of the counter
+            base += static_cast<std::uint32_t>(stamp - last);
+        }
+        last = stamp;
+        item.cycles = base;
+        
+        if(eventCLOCK == item.event)
+        {
+            khz = item.arg;
+        }
+        else if(eventOVERFLOW == item.event)
+        {
+            lostrecords += item.arg;
+        }
+        
+        item.usec = (0 == khz) ? 0 : (1000 * item.cycles / khz);
+        
+        items.push_back(item);
+        
+        return true;
+    }
+};
+
+
+
 // --------------------------------------------------------------------------------------------------------------------
 // - all the rest
 // --------------------------------------------------------------------------------------------------------------------
@@ -446,5 +515,46 @@ const embot::tools::Histogram * embot::tools::PeriodValidator::histogram() const
 }
 
 
+
+const std::uint8_t embot::tools::TraceDecoder::eventCLOCK;
+const std::uint8_t embot::tools::TraceDecoder::eventOVERFLOW;
+
+
+embot::tools::TraceDecoder::TraceDecoder() 
+: pImpl(new Impl)
+{   
+
+}
+
+embot::tools::TraceDecoder::~TraceDecoder()
+{   
+    delete pImpl;
+}
+
+
+bool embot::tools::TraceDecoder::add(const std::uint8_t *data08, std::uint8_t size) 
+{   
+    return pImpl->add(data08, size);
+}
+
+
+bool embot::tools::TraceDecoder::reset()
+{
+    return pImpl->reset();
+}
+
+
+const std::vector<embot::tools::TraceDecoder::Item> & embot::tools::TraceDecoder::timeline() const
+{
+    return pImpl->items;
+}
+
+
+std::uint64_t embot::tools::TraceDecoder::lost() const
+{
+    return pImpl->lostrecords;
+}
+
+
 // - end-of-file (leave a blank line after)----------------------------------------------------------------------------
 
@@ -142,6 +142,53 @@ namespace embot { namespace tools {
 
 
 
+namespace embot { namespace tools {
+    
+    // the object decodes on the host the records of the binary trace of embot::app::application::theCANtracer, which
+    // are transmitted one per can frame with 8 bytes: [stamp (4 bytes, little endian)] [event] [arg (3 bytes, little endian)].
+    // the stamp is in cpu cycles and wraps at 2^32: the decoder unwraps it under the hypothesis that two consecutive 
+    // records are closer than 2^32 cycles, and it converts it into micro-seconds with the clock carried by the event 1.
+    class TraceDecoder
+    {
+    public:
+        
+        static const std::uint8_t eventCLOCK = 1;       // arg is the cpu clock in khz
+        static const std::uint8_t eventOVERFLOW = 2;    // arg is the number of records lost before this one
+        
+        struct Item
+        {
+            std::uint64_t               cycles;         // unwrapped stamp
+            std::uint64_t               usec;           // 0 until a clock event is decoded
+            std::uint8_t                event;
+            std::uint32_t               arg;
+            Item() : cycles(0), usec(0), event(0), arg(0) {}
+        };
+        
+        TraceDecoder();
+        ~TraceDecoder();
+        
+        // it decodes the 8 bytes of a frame and appends the record to the timeline. 
+        bool add(const std::uint8_t *data08, std::uint8_t size = 8);
+        
+        // it removes everything. 
+        bool reset();
+        
+        // the records in order of arrival
+        const std::vector<Item> & timeline() const;
+        
+        // the total number of records lost by the board, as signalled by the overflow events.
+        std::uint64_t lost() const;
+        
+    private:        
+        struct Impl;
+        Impl *pImpl;    
+    };    
+    
+} } // namespace embot { namespace tools {
+
+
+
+
 #endif  // include-guard
 
 
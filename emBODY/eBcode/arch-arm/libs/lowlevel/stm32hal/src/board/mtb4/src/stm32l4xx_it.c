@@ -1,6 +1,6 @@
 
 //IIT-EXT
-//#warning STM32HAL: IIT removed some handlers: systick, pendsv, svc
+//#warning STM32HAL: IIT removed some handlers: systick, pendsv, svc, nmi
 
 /**
   ******************************************************************************
@@ -64,18 +64,7 @@ extern UART_HandleTypeDef huart2;
 /*            Cortex-M4 Processor Interruption and Exception Handlers         */ 
 /******************************************************************************/
 
-/**
-* @brief This function handles Non maskable interrupt.
-*/
-void NMI_Handler(void)
-{
-  /* USER CODE BEGIN NonMaskableInt_IRQn 0 */
-
-  /* USER CODE END NonMaskableInt_IRQn 0 */
-  /* USER CODE BEGIN NonMaskableInt_IRQn 1 */
-
-  /* USER CODE END NonMaskableInt_IRQn 1 */
-}
+//IIT-EXT: NMI_Handler() is in embot_hw.cpp, where it clears the double ECC errors of flash.
 
 /**
 * @brief This function handles Hard fault interrupt.
@@ -50,6 +50,9 @@
 // uncomment to save 1024 bytes of rom
 //#define _USE_HL_CRC32TABLE_IN_ROM_
 
+// define HL_USE_UTIL_CRC32_SLICEBY8 in hl_cfg_plus_modules.h to have hl_crc32_compute() use slice-by-8 with the rom table
+// hl_crc32_table_0x04c11db7. it costs other 7 KB of rom.
+
 // - declaration of public user-defined types ------------------------------------------------------------------------- 
 // empoty-section
 
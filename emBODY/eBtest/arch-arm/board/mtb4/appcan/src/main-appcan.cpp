@@ -20,6 +20,7 @@
 
 #include "embot_app_application_theSkin.h"
 #include "embot_app_application_theIMU.h"
+#include "embot_app_application_theCANtracer.h"
 
 
 static const embot::app::canprotocol::versionOfAPPLICATION vAP = {1, 0 , 1};
@@ -84,14 +85,16 @@ static void eventbasedtask_init(embot::sys::Task *t, void *p);
 static const embot::common::Event evRXcanframe = 0x00000001;
 static const embot::common::Event evSKINprocess = 0x00000002;
 static const embot::common::Event evIMUprocess = 0x00000004;
+static const embot::common::Event evTRACEflush = 0x00000008;
 
 static const std::uint8_t maxOUTcanframes = 48;
+static const std::uint8_t maxTRACEcanframes = 4;
 
 static embot::sys::EventTask* eventbasedtask = nullptr;
 
 static void alerteventbasedtask(void *arg);
 
-static std::vector<embot::hw::can::Frame> outframes;
+static embot::app::FrameStore<maxOUTcanframes> outframes;
 
 static void start_evt_based(void)
 { 
@@ -121,6 +124,13 @@ static void start_evt_based(void)
     configimu.tickevent = evIMUprocess;
     configimu.totask = eventbasedtask;
     theimu.initialise(configimu); 
+    
+    // the binary trace of skin and imu: set tracing true to stream its records over can in idle time.
+    embot::app::application::theCANtracer &tracer = embot::app::application::theCANtracer::getInstance();
+    embot::app::application::theCANtracer::Config configtracer;
+    configtracer.canaddress = embot::app::theCANboardInfo::getInstance().getCANaddress();
+    configtracer.tracing = false;
+    tracer.initialise(configtracer);
 
     // finally start can. i keep it as last because i dont want that the isr-handler calls its onrxframe() 
     // before the eventbasedtask is created.
@@ -146,9 +156,6 @@ static void eventbasedtask_init(embot::sys::Task *t, void *p)
 {
     embot::hw::result_t r = embot::hw::can::enable(embot::hw::can::Port::one);  
     r = r;  
-
-    outframes.reserve(maxOUTcanframes);
-    #warning --> we should init the objects which holds outframes with maxOUTcanframes ... so that no more than maxOUTcanframes are pushed_back
 }
     
 
@@ -219,15 +226,19 @@ static void eventbasedtask_onevent(embot::sys::Task *t, embot::common::EventMask
         
     }
     
+    if(true == embot::common::msk::check(eventmask, evTRACEflush))
+    {
+        // the evTRACEflush is emitted by the idle task only when the can output queue is empty, 
+        // so that the trace records use only what is left of the bus. 
+        embot::app::application::theCANtracer &tracer = embot::app::application::theCANtracer::getInstance();
+        tracer.flush(outframes, maxTRACEcanframes);
+    }
+    
     // if we have any packet we transmit them
     std::uint8_t num = outframes.size();
     if(num > 0)
     {
-        for(std::uint8_t i=0; i<num; i++)
-        {
-            embot::hw::can::put(embot::hw::can::Port::one, outframes[i]);                                       
-        }
-
+        embot::hw::can::put(embot::hw::can::Port::one, outframes.data(), num);
         embot::hw::can::transmit(embot::hw::can::Port::one);  
     } 
  
@@ -238,6 +249,14 @@ static void userdefonidle(void* param)
     static std::uint32_t cnt = 0;
     
     cnt++;
+    
+    // the idle task cannot put frames into the can queue because its only producer is the eventbasedtask: 
+    // hence we ask to it to flush the trace.
+    if((nullptr != eventbasedtask) && (0 == embot::hw::can::outputqueuesize(embot::hw::can::Port::one)) && 
+       (embot::app::application::theCANtracer::getInstance().pending() > 0))
+    {
+        eventbasedtask->setEvent(evTRACEflush);
+    }
 }
 
 
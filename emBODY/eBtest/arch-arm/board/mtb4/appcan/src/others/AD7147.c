@@ -238,6 +238,20 @@ extern void ad7147_acquire(void)
 }
 
 
+extern void ad7147_acquire_triangles(uint16_t trianglesmask)
+{
+    uint8_t i = 0;
+    for(i=0; i<4; i++)
+    {
+        // triangles i, i+4, i+8, i+12 share the device address AD7147_ADD[i] on the four SDA lines
+        if(0 != (trianglesmask & (0x1111 << i)))
+        {
+            ReadViaI2C(0, AD7147_ADD[i], (ADCRESULT_S0), 12, s_AD7147Registers[i], s_AD7147Registers[i+4], s_AD7147Registers[i+8], s_AD7147Registers[i+12], 0);
+        }
+    }
+}
+
+
 extern if2hw_data_ad7147_t * ad7147_get12rawvaluesoftriangle(uint8_t trg)
 {
     if(trg >= triangles_max_num)
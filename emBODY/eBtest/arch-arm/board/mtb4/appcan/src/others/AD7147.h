@@ -109,6 +109,9 @@ extern void ad7147_calibrate(void);
 extern void ad7147_set_cdcoffset(uint8_t trg, uint16_t cdcoffset);
 extern uint16_t ad7147_gettrianglesconnectedmask();
 extern void ad7147_acquire(void);
+// it acquires only the triangles in trianglesmask. as the triangles t, t+4, t+8, t+12 are read all together 
+// on the four SDA lines, it actually acquires every group of four which contains at least one triangle of the mask.
+extern void ad7147_acquire_triangles(uint16_t trianglesmask);
 extern uint8_t ad7147_istriangleconnected(uint8_t trg);
 extern if2hw_data_ad7147_t * ad7147_get12rawvaluesoftriangle(uint8_t trg); 
 extern if2hw_data_ad7147_t * ad7147_get12capoffsetsoftriangle(uint8_t trg);
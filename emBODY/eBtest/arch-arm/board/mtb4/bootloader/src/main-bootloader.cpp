@@ -33,7 +33,7 @@ static const embot::common::relTime BlinkFastPeriod = 2*EOK_reltime100ms;
 static const embot::common::relTime BlinkSlowPeriod = 5*EOK_reltime100ms;
 static const embot::common::relTime BlinkMadlyPeriod = 5*EOK_reltime10ms;
 
-static const embot::app::canprotocol::versionOfBOOTLOADER vBL = {1, 0};
+static const embot::app::canprotocol::versionOfBOOTLOADER vBL = {1, 1}; // 1.1 is the first which reads the storage in embot::hw::FlashStorage::Layout::log
 static const std::uint8_t defADDRESS = 1;
 static const char defaultInfo32[] = {"I am a stm32l4"};
 
@@ -94,7 +94,7 @@ static embot::sys::EventTask* eventbasedtask = nullptr;
 
 static void alerteventbasedtask(void *arg);
 
-static std::vector<embot::hw::can::Frame> outframes;
+static embot::app::FrameStore<12> outframes;
 
 static void bl_activity(void* param)
 {
@@ -153,8 +153,6 @@ static void eventbasedtask_init(embot::sys::Task *t, void *p)
 {
     embot::hw::result_t r = embot::hw::can::enable(embot::hw::can::Port::one);  
     r = r;  
-
-    outframes.reserve(12);
 }
     
 